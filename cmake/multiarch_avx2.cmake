@@ -0,0 +1,55 @@
+# We use GCC/Clang's function multi-versioning for AVX2
+# support. popcount() and countkTuplets() will
+# automatically dispatch to the AVX2 algorithm if the
+# CPU supports it and use the default (portable)
+# algorithm otherwise.
+
+include(CheckCXXSourceCompiles)
+include(CMakePushCheckState)
+
+cmake_push_check_state()
+set(CMAKE_REQUIRED_INCLUDES "${PROJECT_SOURCE_DIR}/include")
+
+check_cxx_source_compiles("
+    // GCC/Clang function multiversioning for AVX2 is not
+    // needed if the user compiles with -mavx2.
+    #if defined(__AVX2__)
+      Error: AVX2 multiarch not needed!
+    #endif
+
+    #include <primesieve/cpu_supports_avx2.hpp>
+    #include <immintrin.h>
+    #include <stdint.h>
+
+    __attribute__ ((target (\"avx2\")))
+    uint64_t popcount_avx2(const uint64_t* array)
+    {
+        __m256i vect = _mm256_loadu_si256((const __m256i*) array);
+        __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        __m256i low4 = _mm256_and_si256(vect, _mm256_set1_epi8(0x0f));
+        __m256i cnt = _mm256_shuffle_epi8(lookup, low4);
+        cnt = _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+        return (uint64_t) _mm256_extract_epi64(cnt, 0);
+    }
+
+    uint64_t popcount_default(const uint64_t* array)
+    {
+        return array[0];
+    }
+
+    int main()
+    {
+        uint64_t array[4] = { 1, 2, 3, 4 };
+        if (cpu_supports_avx2)
+            return (int) popcount_avx2(array);
+        else
+            return (int) popcount_default(array);
+    }
+" multiarch_avx2)
+
+if(multiarch_avx2)
+    set(ENABLE_MULTIARCH_AVX2 "ENABLE_MULTIARCH_AVX2")
+endif()
+
+cmake_pop_check_state()
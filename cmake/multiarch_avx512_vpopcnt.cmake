@@ -0,0 +1,55 @@
+# We use GCC/Clang's function multi-versioning for AVX512
+# VPOPCNTDQ support. popcount() and countkTuplets() will
+# automatically dispatch to the AVX512 VPOPCNTDQ algorithm if
+# the CPU supports it and use the default (portable) algorithm
+# otherwise.
+
+include(CheckCXXSourceCompiles)
+include(CMakePushCheckState)
+
+cmake_push_check_state()
+set(CMAKE_REQUIRED_INCLUDES "${PROJECT_SOURCE_DIR}/include")
+
+check_cxx_source_compiles("
+    // GCC/Clang function multiversioning for AVX512 is not needed if
+    // the user compiles with -mavx512f -mavx512vpopcntdq.
+    // GCC/Clang function multiversioning generally causes a minor
+    // overhead, hence we disable it if it is not needed.
+    #if defined(__AVX512F__) && \
+        defined(__AVX512VPOPCNTDQ__)
+      Error: AVX512VPOPCNTDQ multiarch not needed!
+    #endif
+
+    #include <primesieve/cpu_supports_avx512_vpopcnt.hpp>
+    #include <immintrin.h>
+    #include <stdint.h>
+
+    __attribute__ ((target (\"avx512f,avx512vpopcntdq\")))
+    uint64_t popcount_avx512(const uint64_t* array)
+    {
+        __m512i vect = _mm512_maskz_loadu_epi64(0x0f, array);
+        vect = _mm512_and_si512(vect, _mm512_srli_epi64(vect, 1));
+        vect = _mm512_popcnt_epi64(vect);
+        return _mm512_reduce_add_epi64(vect);
+    }
+
+    uint64_t popcount_default(const uint64_t* array)
+    {
+        return array[0];
+    }
+
+    int main()
+    {
+        uint64_t array[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        if (cpu_supports_avx512_vpopcnt)
+            return (int) popcount_avx512(array);
+        else
+            return (int) popcount_default(array);
+    }
+" multiarch_avx512_vpopcnt)
+
+if(multiarch_avx512_vpopcnt)
+    set(ENABLE_MULTIARCH_AVX512_VPOPCNT "ENABLE_MULTIARCH_AVX512_VPOPCNT")
+endif()
+
+cmake_pop_check_state()
@@ -226,12 +226,39 @@ int primesieve_get_num_threads(void);
 void primesieve_set_sieve_size(int sieve_size);
 
 /**
- * Set the number of threads for use in
- * primesieve_count_*() and primesieve_nth_prime().
+ * Set the number of threads for use in primesieve_count_*(),
+ * primesieve_print_*(), primesieve_nth_prime() and
+ * primesieve_generate_primes().
  * By default all CPU cores are used.
  */
 void primesieve_set_num_threads(int num_threads);
 
+/**
+ * Pin primesieve's worker threads to CPU cores (Linux only) if
+ * pin is not 0. The threads are spread evenly across the NUMA
+ * nodes and their sieve arrays are allocated on their own
+ * NUMA node. The calling thread, which also sieves, is not
+ * pinned. By default the threads are not pinned.
+ */
+void primesieve_set_pin_threads(int pin);
+
+/**
+ * Allocate the sieve arrays and the buckets of the sieving
+ * primes using 2 MiB huge pages (Linux only). Falls back to
+ * the default allocator if huge pages are not available.
+ * By default huge pages are not used.
+ */
+void primesieve_set_huge_pages(int enable);
+
+/**
+ * Load a prime count index file created using
+ * primesieve --build-pi-index=FILE. Afterwards
+ * primesieve_count_primes() uses the index for large intervals.
+ * An empty filename unloads the index. If an error occurs
+ * errno is set to EDOM.
+ */
+void primesieve_set_pi_index(const char* filename);
+
 /**
  * Deallocate a primes array created using the
  * primesieve_generate_primes() or primesieve_generate_n_primes()
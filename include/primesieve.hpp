@@ -17,12 +17,17 @@
 #define PRIMESIEVE_VERSION_MAJOR 12
 #define PRIMESIEVE_VERSION_MINOR 3
 
+#include <primesieve/ForEachPrime.hpp>
 #include <primesieve/iterator.hpp>
 #include <primesieve/primesieve_error.hpp>
 #include <primesieve/StorePrimes.hpp>
 
 #include <stdint.h>
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace primesieve {
 
@@ -38,6 +43,9 @@ inline void generate_primes(uint64_t stop, vect* primes)
 }
 
 /// Appends the primes inside [start, stop] to the end of the primes vector.
+/// Large intervals are sieved in parallel using all CPU cores, use
+/// primesieve::set_num_threads(int threads) to change the number
+/// of threads.
 /// @vect: std::vector or other vector type that is API compatible
 ///        with std::vector.
 ///
@@ -88,6 +96,21 @@ inline void generate_n_primes(uint64_t n, uint64_t start, vect* primes)
 ///
 uint64_t nth_prime(int64_t n, uint64_t start = 0);
 
+/// Find the nth prime for each n of the vector and return the
+/// nth primes in the same order, see nth_prime(n, start).
+/// The primes up to the approximations of all nth primes are
+/// counted in a single parallel pass in which the sieving
+/// primes are generated only once. Hence this is much faster
+/// than calling nth_prime() for each n if there are many n.
+/// If the nth primes are far from start, the primes up to the
+/// lower bound of each nth prime are counted using the LMO
+/// algorithm instead, like nth_prime().
+/// By default all CPU cores are used, use
+/// primesieve::set_num_threads(int threads) to change the
+/// number of threads.
+///
+std::vector<uint64_t> nth_primes(const std::vector<int64_t>& n, uint64_t start = 0);
+
 /// Count the primes within the interval [start, stop].
 /// By default all CPU cores are used, use
 /// primesieve::set_num_threads(int threads) to change the
@@ -97,7 +120,13 @@ uint64_t nth_prime(int64_t n, uint64_t start = 0);
 /// overhead of O(sqrt(stop)) even if the interval [start, stop]
 /// is tiny. Hence if you have written an algorithm that makes
 /// many calls to count_primes() it may be preferable to use
-/// a primesieve::iterator which needs to be initialized only once.
+/// a primesieve::iterator which needs to be initialized only once
+/// or count_primes_batch(). For huge intervals a prime count index
+/// can be used, see set_pi_index().
+///
+/// For large intervals the primes are not sieved, instead
+/// pi(stop) - pi(start - 1) is computed using the LMO algorithm
+/// which runs in O(stop^(2/3) / log(stop)) operations.
 ///
 uint64_t count_primes(uint64_t start, uint64_t stop);
 
@@ -136,6 +165,100 @@ uint64_t count_quintuplets(uint64_t start, uint64_t stop);
 ///
 uint64_t count_sextuplets(uint64_t start, uint64_t stop);
 
+/// Count the primes within each of the intervals [start, stop]
+/// and return the counts in the same order as the intervals.
+/// The intervals are sorted and sieved in a single parallel pass
+/// in which the sieving primes are generated only once. Intervals
+/// that overlap or that are close to each other are sieved only
+/// once. Hence this is much faster than calling count_primes()
+/// for each interval if there are many small intervals.
+/// By default all CPU cores are used, use
+/// primesieve::set_num_threads(int threads) to change the
+/// number of threads.
+///
+std::vector<uint64_t> count_primes_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals);
+
+/// Count the twin primes within each of the intervals
+/// [start, stop], see count_primes_batch().
+///
+std::vector<uint64_t> count_twins_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals);
+
+/// Count the prime triplets within each of the intervals
+/// [start, stop], see count_primes_batch().
+///
+std::vector<uint64_t> count_triplets_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals);
+
+/// Count the prime quadruplets within each of the intervals
+/// [start, stop], see count_primes_batch().
+///
+std::vector<uint64_t> count_quadruplets_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals);
+
+/// Count the prime quintuplets within each of the intervals
+/// [start, stop], see count_primes_batch().
+///
+std::vector<uint64_t> count_quintuplets_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals);
+
+/// Count the prime sextuplets within each of the intervals
+/// [start, stop], see count_primes_batch().
+///
+std::vector<uint64_t> count_sextuplets_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals);
+
+/// Split [start, stop] into n disjoint shards and return the
+/// ith shard (0 <= i < n). The shards cover [start, stop] and
+/// the shard boundaries are chosen so that prime k-tuplets
+/// are never split between two shards. Hence the primes and
+/// prime k-tuplets of each shard can be counted separately,
+/// e.g. on different machines, and the sum of the counts is
+/// the count of [start, stop]. If the ith shard is empty,
+/// then first > second.
+/// Throws a primesieve_error if i >= n.
+///
+std::pair<uint64_t, uint64_t> get_shard(uint64_t start, uint64_t stop, uint64_t i, uint64_t n);
+
+/// Calls callback(primes, size, thread) for each block of primes
+/// inside [start, stop] using multi-threading. The interval is
+/// split into disjoint chunks which are processed in parallel,
+/// hence the callback is called concurrently by different
+/// threads and the blocks are not passed in ascending order.
+/// Within the same thread the blocks are passed in ascending
+/// order. Use the thread parameter (0 <= thread < get_num_threads())
+/// to accumulate per-thread results without synchronization.
+/// By default all CPU cores are used, use
+/// primesieve::set_num_threads(int threads) to change the
+/// number of threads.
+///
+void parallel_for_each_prime_block(uint64_t start,
+                                   uint64_t stop,
+                                   const std::function<void(const uint64_t* primes, std::size_t size, int thread)>& callback);
+
+/// Calls callback(sieve, size, low) for each sieved segment of
+/// the interval [start, stop] in ascending order. The sieve array
+/// is passed without decoding the primes: each byte corresponds to
+/// 30 numbers and the 8 bits of the byte sieve[i] correspond to the
+/// numbers low + i * 30 + { 7, 11, 13, 17, 19, 23, 29, 31 }. A bit
+/// is set if the corresponding number is a prime inside
+/// [start, stop]. The primes 2, 3 and 5 are not part of the sieve
+/// array. The sieve array is padded with zero bytes to a multiple
+/// of 8 bytes and it is only valid until the callback returns.
+///
+void for_each_segment(uint64_t start,
+                      uint64_t stop,
+                      const std::function<void(const uint8_t* sieve, std::size_t size, uint64_t low)>& callback);
+
+/// Same as for_each_segment(), but the interval [start, stop]
+/// is split into disjoint chunks which are sieved in parallel.
+/// Hence the callback is called concurrently by different threads
+/// (0 <= thread < get_num_threads()). Adjacent chunks may share
+/// the same first/last byte (same low), but each prime is set
+/// in exactly one of the two sieve arrays.
+/// By default all CPU cores are used, use
+/// primesieve::set_num_threads(int threads) to change the
+/// number of threads.
+///
+void parallel_for_each_segment(uint64_t start,
+                               uint64_t stop,
+                               const std::function<void(const uint8_t* sieve, std::size_t size, uint64_t low, int thread)>& callback);
+
 /// Print the primes within the interval [start, stop]
 /// to the standard output.
 ///
@@ -184,12 +307,40 @@ int get_num_threads();
 ///
 void set_sieve_size(int sieve_size);
 
-/// Set the number of threads for use in
-/// primesieve::count_*() and primesieve::nth_prime().
+/// Set the number of threads for use in primesieve::count_*(),
+/// primesieve::print_*(), primesieve::nth_prime() and
+/// primesieve::generate_primes().
 /// By default all CPU cores are used.
 ///
 void set_num_threads(int num_threads);
 
+/// Pin primesieve's worker threads to CPU cores (Linux only).
+/// The threads are spread evenly across the NUMA nodes and their
+/// sieve arrays are allocated on their own NUMA node. The calling
+/// thread, which also sieves, is not pinned. This may improve
+/// performance on servers with multiple CPU sockets.
+/// By default the threads are not pinned.
+///
+void set_pin_threads(bool pin);
+
+/// Allocate the sieve arrays and the buckets of the sieving primes
+/// using 2 MiB huge pages (Linux only). This reduces TLB misses
+/// when sieving with large sieving primes > 10^15. Uses explicit
+/// huge pages if these have been reserved, otherwise transparent
+/// huge pages. If huge pages are not available the default
+/// allocator is used. By default huge pages are not used.
+///
+void set_huge_pages(bool enable);
+
+/// Load a prime count index file created using
+/// primesieve --build-pi-index=FILE. Afterwards count_primes()
+/// uses the index for large intervals, hence it only needs to
+/// sieve the numbers near start and stop that are not covered
+/// by the index. An empty filename unloads the index.
+/// Throws a primesieve_error if the file is not a valid index.
+///
+void set_pi_index(const std::string& filename);
+
 /// Get the primesieve version number, in the form “i.j”.
 std::string primesieve_version();
 
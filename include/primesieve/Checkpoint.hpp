@@ -0,0 +1,62 @@
+///
+/// @file  Checkpoint.hpp
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include "PrimeSieve.hpp"
+#include "Vector.hpp"
+
+#include <stdint.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+namespace primesieve {
+
+/// A checkpoint file stores the chunks of a long running
+/// ParallelSieve count computation that have already been
+/// sieved, together with the sum of their prime (k-tuplet)
+/// counts. If the computation is interrupted, it can be
+/// resumed from the checkpoint file and only the remaining
+/// chunks need to be sieved.
+///
+class Checkpoint
+{
+public:
+  Checkpoint(const std::string& filename, bool resume);
+  void init(uint64_t start, uint64_t stop, int flags, uint64_t chunkDist, uint64_t chunks);
+  bool nextChunk(uint64_t& i);
+  uint64_t getFinishedChunks() const;
+  const counts_t& getCounts() const { return counts_; }
+  void finishChunk(uint64_t i, const counts_t& counts);
+  void save();
+private:
+  void load();
+  void write();
+  bool isFinished(uint64_t i) const;
+  std::string filename_;
+  std::mutex mutex_;
+  bool isResume_ = false;
+  uint64_t start_ = 0;
+  uint64_t stop_ = 0;
+  int flags_ = 0;
+  uint64_t chunkDist_ = 0;
+  uint64_t chunks_ = 0;
+  /// Chunks < next_ have been handed out by nextChunk()
+  uint64_t next_ = 0;
+  counts_t counts_;
+  /// 1 bit per chunk, set if the chunk has been sieved
+  Vector<uint64_t> finished_;
+  std::chrono::steady_clock::time_point lastSave_;
+};
+
+} // namespace
+
+#endif
@@ -17,10 +17,23 @@
 #include "PrimeSieve.hpp"
 
 #include <stdint.h>
+#include <cstddef>
 
 namespace primesieve {
 
-class Store;
+class PrintBuffer;
+
+void countAllkTuplets(const uint64_t* sieve, std::size_t size, uint64_t* counts);
+
+/// countAllkTuplets() kernels, used for testing
+enum kTupletsKernel
+{
+  KTUPLETS_DEFAULT,
+  KTUPLETS_AVX2,
+  KTUPLETS_AVX512
+};
+
+bool countAllkTuplets(const uint64_t* sieve, std::size_t size, kTupletsKernel kernel, uint64_t* counts);
 
 /// After a segment has been sieved CountPrintPrimes is
 /// used to reconstruct primes and prime k-tuplets from
@@ -33,17 +46,14 @@ public:
   NOINLINE void sieve();
 private:
   uint64_t low_ = 0;
-  /// Count lookup tables for prime k-tuplets
-  Vector<uint8_t> kCounts_[6];
   counts_t& counts_;
   /// Reference to the associated PrimeSieve object
   PrimeSieve& ps_;
-  MemoryPool memoryPool_;
-  void initCounts();
+  MemoryPool& memoryPool_;
   void countPrimes();
   void countkTuplets();
-  void printPrimes() const;
-  void printkTuplets() const;
+  void printPrimes(PrintBuffer&) const;
+  void printkTuplets(PrintBuffer&) const;
 };
 
 } // namespace
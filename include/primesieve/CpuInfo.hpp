@@ -14,6 +14,7 @@
 
 #include <cstddef>
 #include <string>
+#include <vector>
 
 namespace primesieve {
 
@@ -22,8 +23,13 @@ class CpuInfo
 public:
   CpuInfo();
   bool hasCpuName() const;
+  bool hasAVX2() const;
   bool hasAVX512() const;
+  bool hasAVX512VPOPCNT() const;
   bool hasLogicalCpuCores() const;
+  bool hasAffinityCpuCores() const;
+  bool hasCpuQuota() const;
+  bool hasNumaNodes() const;
   bool hasL1Cache() const;
   bool hasL2Cache() const;
   bool hasL3Cache() const;
@@ -39,12 +45,22 @@ public:
   std::size_t l2Sharing() const;
   std::size_t l3Sharing() const;
   std::size_t logicalCpuCores() const;
+  std::size_t affinityCpuCores() const;
+  std::size_t availableCpuCores() const;
+  double cpuQuota() const;
+  std::size_t numaNodes() const;
+  const std::vector<std::size_t>& numaNodeCpus(std::size_t node) const;
 
 private:
   void init();
   std::size_t logicalCpuCores_;
+  std::size_t affinityCpuCores_;
+  /// cgroup CPU quota in CPU cores, 0 if no quota
+  double cpuQuota_;
   Array<std::size_t, 4> cacheSizes_;
   Array<std::size_t, 4> cacheSharing_;
+  /// Logical CPU core IDs of each NUMA node
+  std::vector<std::vector<std::size_t>> numaNodeCpus_;
   std::string error_;
 };
 
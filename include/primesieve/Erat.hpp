@@ -14,11 +14,13 @@
 #include "EratSmall.hpp"
 #include "EratMedium.hpp"
 #include "EratBig.hpp"
+#include "HugePages.hpp"
 #include "macros.hpp"
 #include "intrinsics.hpp"
 #include "Vector.hpp"
 
 #include <stdint.h>
+#include <cstddef>
 
 namespace primesieve {
 
@@ -35,21 +37,26 @@ class Erat
 {
 public:
   uint64_t getStop() const;
+  uint64_t getMaxStop() const;
 
 protected:
   /// Sieve primes >= start_
   uint64_t start_ = 0;
   /// Sieve primes <= stop_
   uint64_t stop_ = 0;
+  /// stop_ may later be increased up to maxStop_
+  uint64_t maxStop_ = 0;
   /// Lower bound of the current segment
   uint64_t segmentLow_ = ~0ull;
   /// Upper bound of the current segment
   uint64_t segmentHigh_ = 0;
   /// Sieve of Eratosthenes array
-  Vector<uint8_t> sieve_;
+  SieveArray sieve_;
   Erat() = default;
   Erat(uint64_t, uint64_t);
   void init(uint64_t, uint64_t, uint64_t, PreSieve&, MemoryPool& memoryPool);
+  void init(uint64_t, uint64_t, uint64_t, uint64_t, PreSieve&, MemoryPool& memoryPool);
+  void extendStop(uint64_t);
   void addSievingPrime(uint64_t);
   NOINLINE void sieveSegment();
   bool hasNextSegment() const;
@@ -59,6 +66,8 @@ private:
   uint64_t maxPreSieve_ = 0;
   uint64_t maxEratSmall_ = 0;
   uint64_t maxEratMedium_ = 0;
+  /// EratSmall sieve size
+  std::size_t l1CacheSize_ = 0;
   PreSieve* preSieve_ = nullptr;
   EratSmall eratSmall_;
   EratBig eratBig_;
@@ -66,9 +75,8 @@ private:
   static uint64_t byteRemainder(uint64_t);
   static uint64_t getL1CacheSize();
   void initAlgorithms(uint64_t maxSieveSize, MemoryPool&);
-  void preSieve();
-  void crossOff();
-  void sieveLastSegment();
+  void sieveBlocks();
+  void nextSegment();
 };
 
 /// Convert the 1st set bit into a prime number.
@@ -112,6 +120,11 @@ inline uint64_t Erat::getStop() const
   return stop_;
 }
 
+inline uint64_t Erat::getMaxStop() const
+{
+  return maxStop_;
+}
+
 } // namespace
 
 #endif
@@ -11,6 +11,7 @@
 #define ERATBIG_HPP
 
 #include "Bucket.hpp"
+#include "HugePages.hpp"
 #include "macros.hpp"
 #include "Vector.hpp"
 #include "Wheel.hpp"
@@ -29,7 +30,7 @@ class EratBig : public Wheel210_t
 {
 public:
   void init(uint64_t, uint64_t, uint64_t, MemoryPool&);
-  NOINLINE void crossOff(Vector<uint8_t>& sieve);
+  NOINLINE void crossOff(SieveArray& sieve);
   bool hasSievingPrimes() const { return !buckets_.empty(); }
 private:
   uint64_t maxPrime_ = 0;
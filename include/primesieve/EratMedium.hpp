@@ -11,6 +11,7 @@
 #define ERATMEDIUM_HPP
 
 #include "Bucket.hpp"
+#include "HugePages.hpp"
 #include "macros.hpp"
 #include "Vector.hpp"
 #include "Wheel.hpp"
@@ -30,7 +31,7 @@ class EratMedium : public Wheel30_t
 public:
   void init(uint64_t, uint64_t, MemoryPool&);
   bool hasSievingPrimes() const { return !buckets_.empty(); }
-  NOINLINE void crossOff(Vector<uint8_t>& sieve);
+  NOINLINE void crossOff(SieveArray& sieve);
 private:
   uint64_t maxPrime_ = 0;
   MemoryPool* memoryPool_ = nullptr;
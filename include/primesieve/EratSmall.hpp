@@ -11,6 +11,7 @@
 #define ERATSMALL_HPP
 
 #include "Bucket.hpp"
+#include "HugePages.hpp"
 #include "macros.hpp"
 #include "Vector.hpp"
 #include "Wheel.hpp"
@@ -28,14 +29,14 @@ class EratSmall : public Wheel30_t
 {
 public:
   void init(uint64_t, uint64_t, uint64_t);
-  void crossOff(Vector<uint8_t>& sieve);
+  void crossOff(SieveArray& sieve);
+  NOINLINE void crossOff(uint8_t* sieve, std::size_t sieveSize);
   bool hasSievingPrimes() const { return !primes_.empty(); }
 private:
   uint64_t maxPrime_ = 0;
   std::size_t l1CacheSize_ = 0;
   Vector<SievingPrime> primes_;
   void storeSievingPrime(uint64_t, uint64_t, uint64_t);
-  NOINLINE void crossOff(uint8_t*, std::size_t);
 };
 
 } // namespace
@@ -0,0 +1,40 @@
+///
+/// @file  EratTuning.hpp
+/// @brief The thresholds between the EratSmall, EratMedium and
+///        EratBig algorithms are runtime parameters. Their
+///        default values are FACTOR_ERATSMALL and
+///        FACTOR_ERATMEDIUM (see config.hpp) and they can be
+///        changed using setEratTuning() before sieving.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef ERATTUNING_HPP
+#define ERATTUNING_HPP
+
+namespace primesieve {
+
+struct EratTuning
+{
+  /// Sieving primes <= (L1 cache size * factorEratSmall)
+  /// are processed in EratSmall.
+  double factorEratSmall;
+  /// Sieving primes <= (sieveSize * factorEratMedium)
+  /// are processed in EratMedium, larger sieving
+  /// primes are processed in EratBig.
+  double factorEratMedium;
+};
+
+const EratTuning& getEratTuning();
+
+/// Not thread safe, must not be called while sieving.
+/// @pre 0 < factor <= 4.5
+///
+void setEratTuning(double factorEratSmall, double factorEratMedium);
+
+} // namespace
+
+#endif
@@ -0,0 +1,80 @@
+///
+/// @file   ForEachPrime.hpp
+/// @brief  Call a function for each prime inside [start, stop]
+///         without storing the primes in a vector.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef FOREACHPRIME_HPP
+#define FOREACHPRIME_HPP
+
+#include "iterator.hpp"
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+
+namespace primesieve {
+
+/// Calls callback(const uint64_t* primes, std::size_t size) for
+/// each block of primes inside [start, stop] in ascending order.
+/// The primes are passed straight from primesieve::iterator's
+/// internal buffer, the block is only valid until the callback
+/// returns.
+///
+template <typename F>
+inline void for_each_prime_block(uint64_t start,
+                                 uint64_t stop,
+                                 F&& callback)
+{
+  if (start > stop)
+    return;
+
+  uint64_t maxPrime64bits = 18446744073709551557ull;
+  if (start > maxPrime64bits)
+    return;
+
+  primesieve::iterator it(start, stop);
+  it.generate_next_primes();
+
+  // primesieve::iterator throws an exception if one tries to
+  // generate primes > 2^64. Hence we must avoid calling
+  // generate_next_primes() after the largest 64-bit prime.
+  uint64_t limit = std::min(stop, maxPrime64bits - 1);
+
+  for (; it.primes_[it.size_ - 1] <= limit; it.generate_next_primes())
+    callback((const uint64_t*) it.primes_, it.size_);
+
+  const uint64_t* end = std::upper_bound(it.primes_, it.primes_ + it.size_, limit);
+  std::size_t size = (std::size_t) (end - it.primes_);
+
+  if (size > 0)
+    callback((const uint64_t*) it.primes_, size);
+
+  if (stop >= maxPrime64bits)
+    callback((const uint64_t*) &maxPrime64bits, (std::size_t) 1);
+}
+
+/// Calls callback(uint64_t prime) for each
+/// prime inside [start, stop] in ascending order.
+///
+template <typename F>
+inline void for_each_prime(uint64_t start,
+                           uint64_t stop,
+                           F&& callback)
+{
+  for_each_prime_block(start, stop,
+    [&](const uint64_t* primes, std::size_t size)
+    {
+      for (std::size_t i = 0; i < size; i++)
+        callback(primes[i]);
+    });
+}
+
+} // namespace
+
+#endif
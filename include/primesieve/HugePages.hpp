@@ -0,0 +1,70 @@
+///
+/// @file  HugePages.hpp
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef HUGEPAGES_HPP
+#define HUGEPAGES_HPP
+
+#include "config.hpp"
+#include "Vector.hpp"
+
+#include <cstddef>
+#include <memory>
+
+namespace primesieve {
+
+bool isHugePages();
+void setHugePages(bool enable);
+void* allocateHugePages(std::size_t bytes);
+bool deallocateHugePages(void* ptr);
+
+/// Stateless allocator for large arrays. If huge pages have been
+/// enabled using setHugePages(true), allocations of at least
+/// config::HUGE_PAGE_SIZE bytes are backed by huge pages. This
+/// reduces TLB misses when the array is accessed randomly.
+/// Otherwise (or if the operating system does not support huge
+/// pages) the memory is allocated using std::allocator.
+///
+template <typename T>
+class HugePageAllocator
+{
+public:
+  using value_type = T;
+  HugePageAllocator() noexcept = default;
+
+  template <typename U>
+  HugePageAllocator(const HugePageAllocator<U>&) noexcept { }
+
+  T* allocate(std::size_t n)
+  {
+    std::size_t bytes = n * sizeof(T);
+
+    if (bytes >= config::HUGE_PAGE_SIZE && isHugePages())
+    {
+      void* ptr = allocateHugePages(bytes);
+      if (ptr)
+        return (T*) ptr;
+    }
+
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* ptr, std::size_t n) noexcept
+  {
+    if (n * sizeof(T) < config::HUGE_PAGE_SIZE ||
+        !deallocateHugePages(ptr))
+      std::allocator<T>().deallocate(ptr, n);
+  }
+};
+
+/// Sieve array which may be backed by huge pages
+using SieveArray = Vector<uint8_t, HugePageAllocator<uint8_t>>;
+
+} // namespace
+
+#endif
@@ -10,7 +10,9 @@
 #ifndef ITERATOR_HELPER_HPP
 #define ITERATOR_HELPER_HPP
 
+#include "config.hpp"
 #include "PrimeGenerator.hpp"
+#include "PrefetchThread.hpp"
 #include "PreSieve.hpp"
 #include "macros.hpp"
 #include "Vector.hpp"
@@ -29,10 +31,22 @@ struct IteratorData
 
   ~IteratorData()
   {
+    // The prefetch thread uses the primeGenerator,
+    // hence it must be stopped first.
+    delete prefetchThread;
     if (primeGenerator)
       primeGenerator->~PrimeGenerator();
   }
 
+  void deletePrefetchThread()
+  {
+    if (prefetchThread)
+    {
+      delete prefetchThread;
+      prefetchThread = nullptr;
+    }
+  }
+
   void deletePrimeGenerator()
   {
     if (primeGenerator)
@@ -55,12 +69,17 @@ struct IteratorData
     // into an existing buffer. This way we don't
     // need to allocate any new memory.
     ASSERT(primeGenerator == nullptr);
-    primeGenerator = new (primeGeneratorBuffer) PrimeGenerator(start, stop, preSieve);
+    primeGenerator = new (primeGeneratorBuffer) PrimeGenerator(start, stop, preSieve, batchSize);
   }
 
   uint64_t stop;
   uint64_t dist = 0;
   bool include_start_number = true;
+  /// Generate the next primes in a background thread
+  bool prefetch = false;
+  /// Max number of primes generated at once by next_prime()
+  std::size_t batchSize = config::ITERATOR_PRIMES;
+  PrefetchThread* prefetchThread = nullptr;
   PrimeGenerator* primeGenerator = nullptr;
   Vector<uint64_t> primes;
   PreSieve preSieve;
@@ -11,6 +11,7 @@
 #define MEMORYPOOL_HPP
 
 #include "Bucket.hpp"
+#include "HugePages.hpp"
 #include "macros.hpp"
 #include "Vector.hpp"
 
@@ -21,17 +22,18 @@ class MemoryPool
 public:
   NOINLINE void addBucket(SievingPrime*& sievingPrime);
   void freeBucket(Bucket* bucket);
+  void reset();
 
 private:
   void updateAllocCount();
   void allocateBuckets();
-  void initBuckets(void* alignedPtr);
+  void initBuckets(void* alignedPtr, std::size_t count);
   /// List of empty buckets
   Bucket* stock_ = nullptr;
   /// Number of buckets to allocate
   std::size_t count_ = 0;
   /// Pointers of allocated buckets
-  Vector<Vector<char>> memory_;
+  Vector<Vector<char, HugePageAllocator<char>>> memory_;
 };
 
 } // namespace
@@ -12,9 +12,17 @@
 #ifndef PARALLELSIEVE_HPP
 #define PARALLELSIEVE_HPP
 
+#include "Checkpoint.hpp"
 #include "PrimeSieve.hpp"
+#include "SegmentSieve.hpp"
+#include "SievingPrimesTable.hpp"
+#include "Vector.hpp"
 #include <stdint.h>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
 #include <mutex>
+#include <utility>
 
 namespace primesieve {
 
@@ -28,14 +36,37 @@ public:
   int getNumThreads() const;
   int idealNumThreads() const;
   void setNumThreads(int numThreads);
+  void setCheckpoint(Checkpoint* checkpoint);
   bool tryUpdateStatus(uint64_t);
   virtual void sieve();
+  std::size_t storePrimesSize() const;
+  std::size_t storePrimes(void*, std::size_t, std::size_t);
+  void forEachPrimeBlock(const std::function<void(const uint64_t*, std::size_t, int)>&);
+  void forEachSegment(const std::function<void(const uint8_t*, std::size_t, uint64_t, int)>&);
+  void getShard(uint64_t, uint64_t, uint64_t&, uint64_t&) const;
+  void countBatch(const std::pair<uint64_t, uint64_t>*, std::size_t, int, uint64_t*);
+  void countPrefixes(const uint64_t*, std::size_t, uint64_t*);
+  void nthPrimes(const int64_t*, std::size_t, uint64_t, uint64_t*);
+  const SievingPrimesTable* getSievingPrimesTable() const;
 
 private:
   std::mutex mutex_;
   int numThreads_ = 0;
+  /// If not NULL, the finished chunks are saved to a file
+  Checkpoint* checkpoint_ = nullptr;
+  /// Sieving primes shared by all threads
+  SievingPrimesTable sievingPrimesTable_;
+  void initSievingPrimesTable(int, uint64_t);
+  void nthPrimesBounds(const int64_t*, std::size_t, uint64_t, uint64_t*);
+  bool isSievingPrimesTableSmall(int, uint64_t) const;
   uint64_t getThreadDistance(int) const;
+  Vector<uint64_t> getGuidedChunks(int) const;
+  uint64_t getPrintDistance() const;
+  uint64_t getCheckpointDistance() const;
+  void sieveCheckpoint(int);
+  void printParallel(int);
   uint64_t align(uint64_t) const;
+  void getChunk(uint64_t, uint64_t, uint64_t&, uint64_t&) const;
 };
 
 } // namespace
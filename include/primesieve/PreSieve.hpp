@@ -30,7 +30,9 @@
 #define PRESIEVE_HPP
 
 #include "Vector.hpp"
+
 #include <stdint.h>
+#include <cstddef>
 
 namespace primesieve {
 
@@ -38,15 +40,15 @@ class PreSieve
 {
 public:
   void init(uint64_t start, uint64_t stop);
-  void preSieve(Vector<uint8_t>& sieve, uint64_t segmentLow) const;
+  void preSieve(uint8_t* sieve, std::size_t sieveSize, uint64_t segmentLow) const;
   uint64_t getMaxPrime() const { return maxPrime_; }
 private:
   uint64_t maxPrime_ = 13;
   uint64_t totalDist_ = 0;
   Array<Vector<uint8_t>, 8> buffers_;
   void initBuffers();
-  static void preSieveSmall(Vector<uint8_t>& sieve, uint64_t segmentLow);
-  void preSieveLarge(Vector<uint8_t>& sieve, uint64_t segmentLow) const;
+  static void preSieveSmall(uint8_t* sieve, std::size_t sieveSize, uint64_t segmentLow);
+  void preSieveLarge(uint8_t* sieve, std::size_t sieveSize, uint64_t segmentLow) const;
 };
 
 } // namespace
@@ -0,0 +1,61 @@
+///
+/// @file  PrefetchThread.hpp
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PREFETCHTHREAD_HPP
+#define PREFETCHTHREAD_HPP
+
+#include "Vector.hpp"
+
+#include <stdint.h>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace primesieve {
+
+struct IteratorData;
+
+/// Used by primesieve::iterator's prefetch mode. PrefetchThread
+/// generates the next primes in a background thread while the
+/// user iterates over the current primes. The primes are handed
+/// over using a second primes buffer (double buffering).
+///
+class PrefetchThread
+{
+public:
+  PrefetchThread(IteratorData& iterData, uint64_t start, uint64_t stopHint);
+  ~PrefetchThread();
+  void fillNextPrimes(Vector<uint64_t>& primes, std::size_t* size, bool prefetchNext);
+  uint64_t getStart();
+
+private:
+  /// Generate primes > start_
+  uint64_t start_;
+  uint64_t stopHint_;
+  IteratorData& iterData_;
+  /// The primes buffer of the background thread
+  Vector<uint64_t> primes_;
+  std::size_t size_ = 0;
+  std::exception_ptr error_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool isRequest_ = false;
+  bool isReady_ = false;
+  bool isExit_ = false;
+  std::thread thread_;
+  void run();
+  void sieve();
+  void wait(std::unique_lock<std::mutex>&);
+};
+
+} // namespace
+
+#endif
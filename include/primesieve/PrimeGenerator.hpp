@@ -15,6 +15,7 @@
 #ifndef PRIMEGENERATOR_HPP
 #define PRIMEGENERATOR_HPP
 
+#include "config.hpp"
 #include "Erat.hpp"
 #include "MemoryPool.hpp"
 #include "SievingPrimes.hpp"
@@ -44,7 +45,10 @@ class PreSieve;
 class PrimeGenerator : public Erat
 {
 public:
-  PrimeGenerator(uint64_t start, uint64_t stop, PreSieve& preSieve);
+  PrimeGenerator(uint64_t start,
+                 uint64_t stop,
+                 PreSieve& preSieve,
+                 std::size_t maxNextPrimes = config::ITERATOR_PRIMES);
   void fillPrevPrimes(Vector<uint64_t>& primes, std::size_t* size);
   static uint64_t maxCachedPrime();
 
@@ -82,6 +86,8 @@ private:
   uint64_t low_ = 0;
   uint64_t prime_ = 0;
   uint64_t sieveIdx_ = ~0ull;
+  /// Max number of primes of fillNextPrimes()
+  std::size_t maxNextPrimes_;
   PreSieve& preSieve_;
   MemoryPool memoryPool_;
   SievingPrimes sievingPrimes_;
@@ -0,0 +1,51 @@
+///
+/// @file  PrimePiIndex.hpp
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PRIMEPIINDEX_HPP
+#define PRIMEPIINDEX_HPP
+
+#include "Vector.hpp"
+
+#include <stdint.h>
+#include <string>
+
+namespace primesieve {
+
+/// The prime count index stores pi(i * stride) for
+/// i = 0, 1, ..., size - 1. Using the index we can count the
+/// primes inside [start, stop] by only sieving the numbers
+/// between start (and stop) and the nearest index entry,
+/// that is at most stride numbers in total.
+///
+class PrimePiIndex
+{
+public:
+  void build(uint64_t stop, uint64_t stride);
+  void load(const std::string& filename);
+  void save(const std::string& filename) const;
+  void clear();
+  void setNumThreads(int threads) { threads_ = threads; }
+  bool empty() const { return pi_.empty(); }
+  uint64_t getStride() const { return stride_; }
+  uint64_t getStop() const;
+  bool isUseful(uint64_t start, uint64_t stop) const;
+  uint64_t countPrimes(uint64_t start, uint64_t stop) const;
+private:
+  uint64_t primePi(uint64_t x) const;
+  uint64_t sieveDistance(uint64_t x) const;
+  uint64_t sieve(uint64_t start, uint64_t stop) const;
+  /// pi_[i] = pi(i * stride_)
+  Vector<uint64_t> pi_;
+  uint64_t stride_ = 0;
+  int threads_ = 0;
+};
+
+} // namespace
+
+#endif
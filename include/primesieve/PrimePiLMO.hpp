@@ -0,0 +1,22 @@
+///
+/// @file  PrimePiLMO.hpp
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PRIMEPILMO_HPP
+#define PRIMEPILMO_HPP
+
+#include <stdint.h>
+
+namespace primesieve {
+
+uint64_t primePiLMO(uint64_t x, int threads);
+bool isPrimePiLMOUseful(uint64_t start, uint64_t stop);
+
+} // namespace
+
+#endif
@@ -13,15 +13,19 @@
 #ifndef PRIMESIEVE_CLASS_HPP
 #define PRIMESIEVE_CLASS_HPP
 
+#include "MemoryPool.hpp"
 #include "PreSieve.hpp"
 #include "Vector.hpp"
 
 #include <stdint.h>
+#include <functional>
 
 namespace primesieve {
 
 using counts_t = Array<uint64_t, 6>;
 class ParallelSieve;
+class PrimePiIndex;
+class SievingPrimesTable;
 
 enum
 {
@@ -37,7 +41,11 @@ enum
   PRINT_QUADRUPLETS = 1 << 9,
   PRINT_QUINTUPLETS = 1 << 10,
   PRINT_SEXTUPLETS  = 1 << 11,
-  PRINT_STATUS      = 1 << 12
+  PRINT_STATUS      = 1 << 12,
+  PRINT_UINT32      = 1 << 13,
+  PRINT_UINT64      = 1 << 14,
+  PRINT_VARINT      = 1 << 15,
+  PRINT_BITMAP      = 1 << 16
 };
 
 class PrimeSieve
@@ -51,14 +59,23 @@ public:
   uint64_t getStop() const;
   uint64_t getDistance() const;
   int getSieveSize() const;
+  int getFlags() const;
   double getSeconds() const;
+  uint64_t getMaxStop() const;
   PreSieve& getPreSieve();
+  MemoryPool& getMemoryPool();
+  Vector<char>* getPrintOutput() const;
+  const PrimePiIndex* getPiIndex() const;
+  const SievingPrimesTable* getSievingPrimesTable() const;
   // Setters
   void setStart(uint64_t);
   void setStop(uint64_t);
   void updateStatus(uint64_t);
   void setSieveSize(int);
   void setFlags(int);
+  void setPrintOutput(Vector<char>*);
+  void setNextChunk(const std::function<bool(uint64_t&)>*);
+  void setPiIndex(const PrimePiIndex*);
   void addFlags(int);
   // Bool is*
   bool isCount(int) const;
@@ -72,6 +89,7 @@ public:
   bool isFlag(int, int) const;
   bool isStatus() const;
   // Sieve
+  bool nextChunk();
   virtual void sieve();
   void sieve(uint64_t, uint64_t);
   void sieve(uint64_t, uint64_t, int);
@@ -107,8 +125,18 @@ private:
   int sieveSize_ = 0;
   /// Status updates must be synchronized by main thread
   ParallelSieve* parent_ = nullptr;
+  /// If not NULL, primes are printed into this buffer
+  Vector<char>* printOutput_ = nullptr;
+  /// If not NULL, returns the stop number of
+  /// the next chunk that is adjacent to stop_
+  const std::function<bool(uint64_t&)>* nextChunk_ = nullptr;
+  /// If not NULL, nthPrime() counts the primes using the index
+  const PrimePiIndex* piIndex_ = nullptr;
   PreSieve preSieve_;
+  /// Reused by all sieve() calls
+  MemoryPool memoryPool_;
   void processSmallPrimes();
+  uint64_t nthPrimeIndex(int64_t, uint64_t);
   static void printStatus(double, double);
 };
 
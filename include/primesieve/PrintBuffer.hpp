@@ -0,0 +1,205 @@
+///
+/// @file   PrintBuffer.hpp
+/// @brief  PrintBuffer encodes primes into a large buffer which is
+///         then written to stdout using std::fwrite(). This is much
+///         faster than printing primes using std::ostream. Apart from
+///         text output, PrintBuffer also supports binary output
+///         formats: little-endian uint32 and uint64, delta encoded
+///         varint (LEB128) and the raw sieve array (bitmap).
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef PRINTBUFFER_HPP
+#define PRINTBUFFER_HPP
+
+#include "config.hpp"
+#include "macros.hpp"
+#include "PrimeSieve.hpp"
+#include "Vector.hpp"
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace primesieve {
+
+class PrintBuffer
+{
+public:
+  /// @flags:  PrimeSieve flags, used to select the output format.
+  /// @prev:   Previous prime, used by the varint format.
+  /// @output: If not NULL, the output is appended to this
+  ///          vector instead of being written to stdout.
+  ///
+  PrintBuffer(int flags,
+              uint64_t prev = 0,
+              Vector<char>* output = nullptr) :
+    prev_(prev),
+    output_(output)
+  {
+    if (flags & PRINT_UINT32)
+      format_ = PRINT_UINT32;
+    else if (flags & PRINT_UINT64)
+      format_ = PRINT_UINT64;
+    else if (flags & PRINT_VARINT)
+      format_ = PRINT_VARINT;
+    else if (flags & PRINT_BITMAP)
+      format_ = PRINT_BITMAP;
+  }
+
+  ~PrintBuffer()
+  {
+    flush();
+  }
+
+  int getFormat() const
+  {
+    return format_;
+  }
+
+  ALWAYS_INLINE void print(uint64_t prime)
+  {
+    if_unlikely(size_ + MAX_BYTES > buffer_.size())
+      makeRoom();
+
+    switch (format_)
+    {
+      case PRINT_UINT32: encodeLittleEndian(prime, 4); break;
+      case PRINT_UINT64: encodeLittleEndian(prime, 8); break;
+      case PRINT_VARINT: size_ += encodeVarint(prime - prev_, &buffer_[size_]); prev_ = prime; break;
+      default: encodeText(prime);
+    }
+  }
+
+  /// Write raw bytes, used to print the sieve
+  /// array and prime k-tuplets.
+  ///
+  void write(const void* bytes, std::size_t size)
+  {
+    if (size == 0)
+      return;
+    if (size_ + size > buffer_.size())
+      makeRoom();
+    if (size > buffer_.size())
+      writeOutput((const char*) bytes, size);
+    else
+    {
+      std::memcpy(&buffer_[size_], bytes, size);
+      size_ += size;
+    }
+  }
+
+  void flush()
+  {
+    if (size_ > 0)
+      writeOutput(buffer_.data(), size_);
+    size_ = 0;
+  }
+
+  /// LEB128, 7 bits per byte.
+  /// @return  Number of bytes written (<= 10).
+  ///
+  static std::size_t encodeVarint(uint64_t n, char* out)
+  {
+    std::size_t i = 0;
+    for (; n >= 0x80; n >>= 7)
+      out[i++] = (char) ((n & 0x7f) | 0x80);
+    out[i++] = (char) n;
+    return i;
+  }
+
+  /// Decode the LEB128 varint starting at p.
+  /// @return  Pointer to the next varint.
+  ///
+  static const char* decodeVarint(const char* p, uint64_t* n)
+  {
+    uint64_t res = 0;
+    int shift = 0;
+    for (; *p & 0x80; p++, shift += 7)
+      res |= (uint64_t) (*p & 0x7f) << shift;
+    res |= (uint64_t) *p++ << shift;
+    *n = res;
+    return p;
+  }
+
+private:
+  /// Max number of bytes per prime: 20 digits + '\n'
+  enum { MAX_BYTES = 21 };
+  int format_ = 0;
+  uint64_t prev_ = 0;
+  std::size_t size_ = 0;
+  Vector<char> buffer_;
+  Vector<char>* output_ = nullptr;
+
+  void writeOutput(const char* bytes, std::size_t size)
+  {
+    if (output_)
+      output_->insert(output_->end(), bytes, bytes + size);
+    else
+      std::fwrite(bytes, 1, size, stdout);
+  }
+
+  /// The buffer is allocated on first use
+  void makeRoom()
+  {
+    flush();
+    if (buffer_.empty())
+      buffer_.resize(config::PRINT_BUFFER_BYTES);
+  }
+
+  void encodeText(uint64_t n)
+  {
+    const char* digits =
+      "00010203040506070809"
+      "10111213141516171819"
+      "20212223242526272829"
+      "30313233343536373839"
+      "40414243444546474849"
+      "50515253545556575859"
+      "60616263646566676869"
+      "70717273747576777879"
+      "80818283848586878889"
+      "90919293949596979899";
+
+    // Convert 2 digits at a time, from
+    // the least significant digit.
+    char tmp[MAX_BYTES];
+    char* end = tmp + MAX_BYTES;
+    char* p = end;
+    *--p = '\n';
+
+    for (; n >= 100; n /= 100)
+    {
+      p -= 2;
+      std::memcpy(p, &digits[(n % 100) * 2], 2);
+    }
+
+    if (n >= 10)
+    {
+      p -= 2;
+      std::memcpy(p, &digits[n * 2], 2);
+    }
+    else
+      *--p = (char) ('0' + n);
+
+    std::size_t size = (std::size_t) (end - p);
+    std::memcpy(&buffer_[size_], p, size);
+    size_ += size;
+  }
+
+  /// Byte order independent
+  void encodeLittleEndian(uint64_t n, int bytes)
+  {
+    for (int i = 0; i < bytes; i++)
+      buffer_[size_++] = (char) (n >> (i * 8));
+  }
+};
+
+} // namespace
+
+#endif
@@ -16,5 +16,9 @@ long double RiemannR_inverse(long double x);
 
 uint64_t primePiApprox(uint64_t x);
 uint64_t nthPrimeApprox(uint64_t n);
+uint64_t primePiLower(uint64_t x);
+uint64_t primePiUpper(uint64_t x);
+uint64_t nthPrimeLower(uint64_t n);
+uint64_t nthPrimeUpper(uint64_t n);
 
 } // namespace
@@ -0,0 +1,41 @@
+///
+/// @file  SegmentSieve.hpp
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef SEGMENTSIEVE_HPP
+#define SEGMENTSIEVE_HPP
+
+#include "Erat.hpp"
+#include "MemoryPool.hpp"
+#include "PrimeSieve.hpp"
+
+#include <stdint.h>
+#include <cstddef>
+#include <functional>
+
+namespace primesieve {
+
+using SegmentCallback = std::function<void(const uint8_t*, std::size_t, uint64_t)>;
+
+/// After a segment has been sieved SegmentSieve passes
+/// the sieve array (without decoding the primes) to
+/// a user supplied callback function.
+///
+class SegmentSieve : public Erat
+{
+public:
+  SegmentSieve(PrimeSieve&);
+  void sieve(const SegmentCallback&);
+private:
+  PrimeSieve& ps_;
+  MemoryPool& memoryPool_;
+};
+
+} // namespace
+
+#endif
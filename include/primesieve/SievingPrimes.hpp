@@ -20,13 +20,14 @@ namespace primesieve {
 
 class PreSieve;
 class MemoryPool;
+class SievingPrimesTable;
 
 class SievingPrimes : public Erat
 {
 public:
   SievingPrimes() = default;
-  SievingPrimes(Erat*, uint64_t, PreSieve&, MemoryPool& memoryPool);
-  void init(Erat*, uint64_t, PreSieve&, MemoryPool& memoryPool);
+  SievingPrimes(Erat*, uint64_t, PreSieve&, MemoryPool& memoryPool, const SievingPrimesTable* table = nullptr);
+  void init(Erat*, uint64_t, PreSieve&, MemoryPool& memoryPool, const SievingPrimesTable* table = nullptr);
   uint64_t next();
 private:
   uint64_t i_ = 0;
@@ -34,10 +35,16 @@ private:
   uint64_t low_ = 0;
   uint64_t tinyIdx_ = 0;
   uint64_t sieveIdx_ = ~0ull;
+  uint64_t sieveSize_ = 0;
+  /// Either our own sieve array or the
+  /// shared SievingPrimesTable.
+  const uint8_t* sieveData_ = nullptr;
+  const SievingPrimesTable* table_ = nullptr;
   Array<uint64_t, 128> primes_;
   Vector<bool> tinySieve_;
   NOINLINE void fill();
   void tinySieve();
+  void initTable(uint64_t);
   bool sieveSegment();
 };
 
@@ -0,0 +1,45 @@
+///
+/// @file  SievingPrimesTable.hpp
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef SIEVINGPRIMESTABLE_HPP
+#define SIEVINGPRIMESTABLE_HPP
+
+#include "Vector.hpp"
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace primesieve {
+
+/// Read-only table of the sieving primes <= stop. The table
+/// uses the same bit layout as the sieve array: each byte
+/// corresponds to 30 numbers and its 8 bits correspond to
+/// the offsets { 7, 11, 13, 17, 19, 23, 29, 31 }, byte i
+/// holds the primes inside [i * 30 + 7, i * 30 + 31].
+/// Hence the table uses 1 bit per number coprime to 30 i.e.
+/// less than 143 MiB for all primes < 2^32.
+///
+class SievingPrimesTable
+{
+public:
+  void init(uint64_t stop, int threads);
+  void clear();
+  bool empty() const { return table_.empty(); }
+  uint64_t getStop() const { return stop_; }
+  const uint8_t* data() const { return table_.data(); }
+  std::size_t size() const { return table_.size(); }
+private:
+  uint64_t stop_ = 0;
+  /// The table size is a multiple of 8 bytes
+  Vector<uint8_t> table_;
+};
+
+} // namespace
+
+#endif
@@ -19,7 +19,9 @@
 #include <cmath>
 #include <cstddef>
 #include <limits>
+#include <memory>
 #include <string>
+#include <type_traits>
 
 #if defined(min) || defined(max)
   #undef min
@@ -48,6 +50,27 @@ inline std::size_t prime_count_upper(uint64_t start, uint64_t stop)
   return (std::size_t) pix;
 }
 
+/// Used internally by store_primes(). Returns the size of the
+/// primes buffer required by store_primes_parallel() or 0 if the
+/// interval [start, stop] is too small for multi-threading.
+///
+std::size_t store_primes_parallel_size(uint64_t start, uint64_t stop, int threads);
+
+/// Used internally by store_primes(). Generates the primes inside
+/// [start, stop] using multi-threading and stores them in the
+/// primes buffer whose elements are integers of typeSize bytes.
+/// @return  The number of primes stored in the primes buffer.
+///
+std::size_t store_primes_parallel(uint64_t start,
+                                  uint64_t stop,
+                                  int threads,
+                                  void* primes,
+                                  std::size_t size,
+                                  std::size_t typeSize);
+
+/// Get the current set number of threads
+int get_num_threads();
+
 /// Used to print type name in error messages
 template <typename T> inline std::string getTypeName() { return "Type"; }
 template <> inline std::string getTypeName<int8_t>() { return "int8_t"; }
@@ -83,6 +106,28 @@ inline void store_primes(uint64_t start,
   if (stop > std::numeric_limits<V>::max())
     throw primesieve_error("store_primes(): " + getTypeName<V>() + " is too narrow for generating primes up to " + std::to_string(stop));
 
+  // For large intervals the primes are generated in parallel.
+  // Each thread stores its primes into its own slice of the
+  // primes vector and at the end the slices are compacted.
+  if (std::is_integral<V>::value && sizeof(V) >= 2)
+  {
+    int threads = get_num_threads();
+    std::size_t size = store_primes_parallel_size(start, stop, threads);
+
+    if (size > 0)
+    {
+      // primes.resize() would zero initialize the
+      // buffer using a single thread. Instead the threads
+      // write into an uninitialized buffer and we append
+      // only the primes to the vector.
+      std::unique_ptr<V[]> buffer(new V[size]);
+      std::size_t count = store_primes_parallel(start, stop, threads, buffer.get(), size, sizeof(V));
+      primes.reserve(primes.size() + count);
+      primes.insert(primes.end(), buffer.get(), buffer.get() + count);
+      return;
+    }
+  }
+
   std::size_t size = primes.size() + prime_count_upper(start, stop);
   primes.reserve(size);
 
@@ -0,0 +1,67 @@
+///
+/// @file  ThreadPool.hpp
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include "Vector.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace primesieve {
+
+/// Process-wide pool of worker threads used by ParallelSieve.
+/// The worker threads are created lazily and they are reused
+/// by all subsequent run() calls, hence we don't pay the
+/// cost of creating new threads for each computation.
+///
+class ThreadPool
+{
+public:
+  static ThreadPool& get();
+  ~ThreadPool();
+  void run(int tasks, const std::function<void(int)>& task);
+  void setPinThreads(bool pin);
+
+private:
+  /// The tasks of a single run() call
+  struct Job
+  {
+    const std::function<void(int)>* task;
+    int tasks;
+    int next;
+    int finished;
+    std::exception_ptr error;
+  };
+
+  ThreadPool() = default;
+  void addThreads(int threads);
+  void worker();
+  void setAffinity(std::size_t i);
+  void runTask(Job& job, std::unique_lock<std::mutex>& lock);
+  std::mutex mutex_;
+  /// Notifies the worker threads of new jobs
+  std::condition_variable work_;
+  /// Notifies run() that its job has finished
+  std::condition_variable done_;
+  /// Jobs that have tasks which have not yet been started
+  Vector<Job*> jobs_;
+  Vector<std::thread> threads_;
+  bool isExit_ = false;
+  bool isPinThreads_ = false;
+};
+
+} // namespace
+
+#endif
@@ -43,6 +43,12 @@ constexpr uint64_t BUCKET_BYTES = 8 << 10;
 ///
 constexpr uint64_t MAX_ALLOC_BYTES = 16 << 20;
 
+/// If huge pages are enabled, arrays of at least HUGE_PAGE_SIZE
+/// bytes are allocated using huge pages. This is the size of
+/// the huge pages on x86-64 and arm64 Linux.
+///
+constexpr uint64_t HUGE_PAGE_SIZE = 2 << 20;
+
 /// iterator::prev_prime() caches at least MIN_CACHE_ITERATOR
 /// bytes of primes. Larger is usually faster but also
 /// requires more memory.
@@ -54,12 +60,117 @@ constexpr uint64_t MIN_CACHE_ITERATOR = 4 << 20;
 ///
 constexpr uint64_t MAX_CACHE_ITERATOR = 1 << 30;
 
+/// primesieve::iterator::next_prime() generates up to
+/// ITERATOR_PRIMES primes at once by default, this can be
+/// changed at runtime using iterator::set_batch_size().
+/// A buffer of 1024 primes provides good performance with
+/// little memory usage.
+///
+constexpr uint64_t ITERATOR_PRIMES = 1 << 10;
+
+/// Smallest batch size accepted by iterator::set_batch_size(),
+/// PrimeGenerator::fillNextPrimes() requires space for
+/// at least 64 primes.
+///
+constexpr uint64_t MIN_ITERATOR_PRIMES = 64;
+
+/// In prefetch mode primesieve::iterator's background thread
+/// generates at least max(PREFETCH_PRIMES, batch size) primes
+/// at once. A larger number of primes reduces the thread
+/// synchronization overhead, but increases the latency of the
+/// first next_prime() call.
+///
+constexpr uint64_t PREFETCH_PRIMES = 1 << 14;
+
+/// CountPrintPrimes prints the primes using a buffer of
+/// PRINT_BUFFER_BYTES which is written to stdout using
+/// std::fwrite() once it is full.
+///
+constexpr uint64_t PRINT_BUFFER_BYTES = 1 << 20;
+
 /// Each thread sieves at least a distance of MIN_THREAD_DISTANCE
 /// in order to reduce the initialization overhead.
 /// @pre MIN_THREAD_DISTANCE >= 100
 ///
 constexpr uint64_t MIN_THREAD_DISTANCE = (uint64_t) 1e7;
 
+/// ParallelSieve uses guided scheduling, the chunk size decreases
+/// towards the end of the sieving interval. The smallest chunks
+/// are GUIDED_CHUNKS_MIN_FACTOR times smaller than the
+/// largest chunks.
+///
+constexpr uint64_t GUIDED_CHUNKS_MIN_FACTOR = 16;
+
+/// count_primes_batch() merges two intervals into the same
+/// group (that is sieved only once) if the gap between them
+/// is <= sqrt(stop) / BATCH_MERGE_DIVISOR. Initializing the
+/// sieving primes of a new group costs about as much as
+/// sieving a distance of sqrt(stop) / 2.
+///
+constexpr uint64_t BATCH_MERGE_DIVISOR = 2;
+
+/// Default distance between two entries of the prime count
+/// index built by primesieve --build-pi-index. Using the index,
+/// count_primes() sieves at most PI_INDEX_STRIDE numbers.
+///
+constexpr uint64_t PI_INDEX_STRIDE = 1ull << 32;
+
+/// With a checkpoint file (primesieve --checkpoint) the interval
+/// is split into chunks of size sqrt(stop) * CHECKPOINT_CHUNK_FACTOR
+/// independent of the number of threads, hence a computation can
+/// be resumed using a different number of threads. Each chunk
+/// re-initializes its sieving primes, which costs < 1% for 100.
+///
+constexpr uint64_t CHECKPOINT_CHUNK_FACTOR = 100;
+
+/// The checkpoint file is updated at most
+/// every CHECKPOINT_SECONDS seconds.
+///
+constexpr double CHECKPOINT_SECONDS = 60;
+
+/// After counting the primes up to its approximation, nth_prime(n)
+/// locates the nth prime in the sieve array of the remaining
+/// distance. At most MAX_NTHPRIME_DISTANCE numbers are sieved at
+/// once, their sieve array uses 32 MiB of memory.
+///
+constexpr uint64_t MAX_NTHPRIME_DISTANCE = 30ull << 25;
+
+/// nth_primes() counts the primes up to a grid of stops around
+/// each approximation of an nth prime. The nth prime is usually
+/// within sqrt(approximation) of its approximation, hence the
+/// stops are sqrt(approximation) / NTH_PRIMES_GRID apart and
+/// there are NTH_PRIMES_GRID stops on both sides. Only the
+/// distance between two adjacent stops is sieved again to
+/// locate the nth prime.
+///
+constexpr uint64_t NTH_PRIMES_GRID = 16;
+
+/// count_primes(start, stop) and nth_prime(n) count the primes
+/// using the combinatorial LMO algorithm instead of sieving if
+/// (stop - start) > stop^(2/3) * LMO_SPEEDUP and
+/// stop >= MIN_LMO.
+///
+constexpr uint64_t MIN_LMO = (uint64_t) 1e6;
+constexpr double LMO_SPEEDUP = 100;
+
+/// The LMO algorithm uses y = alpha * x^(1/3) with
+/// alpha = log(x)^2 * LMO_ALPHA.
+///
+constexpr double LMO_ALPHA = 0.005;
+
+/// The LMO special leaves are computed by sieving [1, x / y]
+/// using segments of max(sqrt(x / y), MIN_LMO_SEGMENT_SIZE)
+/// numbers. Each thread sieves a chunk of up to
+/// MAX_LMO_CHUNK_SEGMENTS segments at once.
+///
+constexpr uint64_t MIN_LMO_SEGMENT_SIZE = 1 << 16;
+constexpr uint64_t MAX_LMO_CHUNK_SEGMENTS = 64;
+
+/// The LMO algorithm computes the prime counts pi(x / p) for
+/// up to LMO_P2_STOPS primes using a single sieving pass.
+///
+constexpr uint64_t LMO_P2_STOPS = 1 << 20;
+
 /// Sieving primes <= (L1D_CACHE_BYTES * FACTOR_ERATSMALL) are
 /// processed in EratSmall. When FACTOR_ERATSMALL is small fewer
 /// sieving primes are processed in EratSmall.cpp and more sieving
@@ -71,6 +182,8 @@ constexpr uint64_t MIN_THREAD_DISTANCE = (uint64_t) 1e7;
 /// my tests using a smaller FACTOR_ERATSMALL often improved single
 /// thread performance, but decreased multi-threading performance. On
 /// newer CPUs a smaller FACTOR_ERATSMALL is often faster.
+/// This is the default value, it can be changed at runtime
+/// using setEratTuning().
 ///
 /// @pre FACTOR_ERATSMALL >= 0 && <= 4.5
 ///
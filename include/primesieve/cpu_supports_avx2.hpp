@@ -0,0 +1,52 @@
+///
+/// @file  cpu_supports_avx2.hpp
+/// @brief Detect if the x86 CPU supports AVX2.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef CPU_SUPPORTS_AVX2_HPP
+#define CPU_SUPPORTS_AVX2_HPP
+
+#include "cpuid.hpp"
+
+namespace {
+
+inline bool run_cpuid_avx2()
+{
+  int abcd[4];
+
+  run_cpuid(1, 0, abcd);
+
+  int osxsave_mask = (1 << 27);
+  int avx_mask = (1 << 28);
+
+  // Ensure OS supports extended processor state management
+  if ((abcd[2] & osxsave_mask) != osxsave_mask)
+    return false;
+
+  if ((abcd[2] & avx_mask) != avx_mask)
+    return false;
+
+  int ymm_mask = XSTATE_SSE | XSTATE_YMM;
+
+  // Check AVX OS support
+  if ((get_xcr0() & ymm_mask) != ymm_mask)
+    return false;
+
+  run_cpuid(7, 0, abcd);
+
+  // %ebx AVX2 bit flag
+  int bit_avx2 = 1 << 5;
+  return (abcd[1] & bit_avx2) == bit_avx2;
+}
+
+/// Initialized at startup
+bool cpu_supports_avx2 = run_cpuid_avx2();
+
+} // namespace
+
+#endif
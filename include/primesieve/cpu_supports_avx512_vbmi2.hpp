@@ -13,10 +13,6 @@
 
 #include "cpuid.hpp"
 
-#if defined(_MSC_VER)
-  #include <immintrin.h>
-#endif
-
 // %ebx bit flags
 #define bit_AVX512F (1 << 16)
 
@@ -24,27 +20,8 @@
 #define bit_AVX512VBMI  (1 << 1)
 #define bit_AVX512VBMI2 (1 << 6)
 
-// xgetbv bit flags
-#define XSTATE_SSE (1 << 1)
-#define XSTATE_YMM (1 << 2)
-#define XSTATE_ZMM (7 << 5)
-
 namespace {
 
-// Get Value of Extended Control Register
-inline int get_xcr0()
-{
-  int xcr0;
-
-#if defined(_MSC_VER)
-  xcr0 = (int) _xgetbv(0);
-#else
-  __asm__ ("xgetbv" : "=a" (xcr0) : "c" (0) : "%edx" );
-#endif
-
-  return xcr0;
-}
-
 inline bool run_cpuid_avx512_vbmi2()
 {
   int abcd[4];
@@ -0,0 +1,60 @@
+///
+/// @file  cpu_supports_avx512_vpopcnt.hpp
+/// @brief Detect if the x86 CPU supports AVX512 VPOPCNTDQ.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#ifndef CPU_SUPPORTS_AVX512_VPOPCNT_HPP
+#define CPU_SUPPORTS_AVX512_VPOPCNT_HPP
+
+#include "cpuid.hpp"
+
+namespace {
+
+inline bool run_cpuid_avx512_vpopcnt()
+{
+  int abcd[4];
+
+  run_cpuid(1, 0, abcd);
+
+  int osxsave_mask = (1 << 27);
+
+  // Ensure OS supports extended processor state management
+  if ((abcd[2] & osxsave_mask) != osxsave_mask)
+    return false;
+
+  int ymm_mask = XSTATE_SSE | XSTATE_YMM;
+  int zmm_mask = XSTATE_SSE | XSTATE_YMM | XSTATE_ZMM;
+
+  int xcr0 = get_xcr0();
+
+  // Check AVX OS support
+  if ((xcr0 & ymm_mask) != ymm_mask)
+    return false;
+
+  // Check AVX512 OS support
+  if ((xcr0 & zmm_mask) != zmm_mask)
+    return false;
+
+  run_cpuid(7, 0, abcd);
+
+  // %ebx AVX512F bit flag
+  int bit_avx512f = 1 << 16;
+  // %ecx AVX512_VPOPCNTDQ bit flag
+  int bit_avx512_vpopcntdq = 1 << 14;
+
+  // CountPrintPrimes::countkTuplets() requires AVX512F & AVX512_VPOPCNTDQ
+  return (abcd[1] & bit_avx512f) == bit_avx512f &&
+         (abcd[2] & bit_avx512_vpopcntdq) == bit_avx512_vpopcntdq;
+}
+
+/// Initialized at startup
+bool cpu_supports_avx512_vpopcnt = run_cpuid_avx512_vpopcnt();
+
+} // namespace
+
+#endif
@@ -1,6 +1,6 @@
 ///
 /// @file  cpuid.hpp
-/// @brief CPUID for x86 and x86-64 CPUs.
+/// @brief CPUID & XGETBV for x86 and x86-64 CPUs.
 ///
 /// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
 ///
@@ -13,8 +13,14 @@
 
 #if defined(_MSC_VER)
   #include <intrin.h>
+  #include <immintrin.h>
 #endif
 
+// xgetbv bit flags
+#define XSTATE_SSE (1 << 1)
+#define XSTATE_YMM (1 << 2)
+#define XSTATE_ZMM (7 << 5)
+
 namespace {
 
 inline void run_cpuid(int eax, int ecx, int* abcd)
@@ -50,6 +56,20 @@ inline void run_cpuid(int eax, int ecx, int* abcd)
 #endif
 }
 
+// Get Value of Extended Control Register
+inline int get_xcr0()
+{
+  int xcr0;
+
+#if defined(_MSC_VER)
+  xcr0 = (int) _xgetbv(0);
+#else
+  __asm__ ("xgetbv" : "=a" (xcr0) : "c" (0) : "%edx" );
+#endif
+
+  return xcr0;
+}
+
 } // namespace
 
 #endif
@@ -25,6 +25,16 @@ int get_sieve_size();
 uint64_t get_max_stop();
 uint64_t popcount(const uint64_t* array, uint64_t size);
 
+/// popcount() kernels, used for testing
+enum PopcountKernel
+{
+  POPCOUNT_DEFAULT,
+  POPCOUNT_AVX2,
+  POPCOUNT_AVX512
+};
+
+bool popcount(const uint64_t* array, uint64_t size, PopcountKernel kernel, uint64_t& count);
+
 } // namespace
 
 #endif
@@ -342,4 +342,63 @@ inline int ctz64(uint64_t x)
 
 #endif
 
+// GCC & Clang enable PDEP with -mbmi2. We don't dispatch to PDEP
+// at runtime as PDEP is very slow (microcoded) on AMD CPUs
+// before Zen3, the portable select64() is used instead.
+#if defined(__BMI2__) && \
+    defined(HAS_CTZ64) && \
+    defined(CTZ64_SUPPORTS_ZERO) && \
+    __has_include(<immintrin.h>)
+
+#include <immintrin.h>
+
+namespace {
+
+/// Returns the index of the nth (n >= 0) set bit of x.
+/// @pre n < popcnt64(x)
+///
+inline uint64_t select64(uint64_t x, uint64_t n)
+{
+  ASSERT(n < (uint64_t) popcnt64(x));
+
+  // PDEP deposits the bit (1 << n) at the
+  // position of the nth set bit of x.
+  return (uint64_t) ctz64(_pdep_u64(1ull << n, x));
+}
+
+} // namespace
+
+#else
+
+namespace {
+
+/// Returns the index of the nth (n >= 0) set bit of x.
+/// @pre n < popcnt64(x)
+///
+inline uint64_t select64(uint64_t x, uint64_t n)
+{
+  ASSERT(n < (uint64_t) popcnt64(x));
+  uint64_t bitIndex = 0;
+
+  // Skip the bytes with <= n set bits
+  for (uint64_t count; (count = popcnt64(x & 0xff)) <= n; x >>= 8)
+  {
+    n -= count;
+    bitIndex += 8;
+  }
+
+  // Clear the n lowest set bits
+  for (; n > 0; n--)
+    x &= x - 1;
+
+  for (; (x & 1) == 0; x >>= 1)
+    bitIndex++;
+
+  return bitIndex;
+}
+
+} // namespace
+
+#endif
+
 #endif // INTRINSICS_HPP
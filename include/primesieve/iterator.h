@@ -120,12 +120,13 @@ void primesieve_skipto(primesieve_iterator* it, uint64_t start, uint64_t stop_hi
 /**
  * Used internally by primesieve_next_prime().
  * primesieve_generate_next_primes() fills (overwrites) the primes
- * array with the next few primes (~ 2^10) that are larger than the
- * current largest prime in the primes array or with the
+ * array with the next few primes (~ batch size) that are larger
+ * than the current largest prime in the primes array or with the
  * primes >= start if the primes array is empty.
  * Note that this function also updates the i & size member variables
  * of the primesieve_iterator struct. The size of the primes array
- * varies, but it is > 0 and usually close to 2^10.
+ * varies, but it is > 0 and usually close to the batch size
+ * (2^10 by default).
  * If an error occurs primesieve_iterator.is_error is set to 1
  * and the primes array will contain PRIMESIEVE_ERROR.
  */
@@ -157,6 +158,46 @@ static inline uint64_t primesieve_next_prime(primesieve_iterator* it)
   return it->primes[it->i];
 }
 
+/**
+ * Set the max number of primes that primesieve_next_prime()
+ * generates at once (default 1024). Larger batches reduce the
+ * overhead per prime of primesieve_next_primes() and
+ * primesieve_next_prime_block() which is useful for vectorized
+ * code, but they use more memory. Batch sizes < 64 are rounded
+ * up to 64. The new batch size is used after the primes of the
+ * current segment have been consumed.
+ */
+void primesieve_set_batch_size(primesieve_iterator* it, size_t size);
+
+/**
+ * Copy the next n primes into the primes array.
+ * Same as calling primesieve_next_prime() n times, but faster.
+ * If an error occurs primesieve_iterator.is_error is set to 1
+ * and the remaining primes are set to PRIMESIEVE_ERROR.
+ */
+void primesieve_next_primes(primesieve_iterator* it, uint64_t* primes, size_t n);
+
+/**
+ * Get the next primes as a block of the internal primes array,
+ * without copying them. Returns a pointer to the first prime of
+ * the block and stores the number of primes (> 0) in *size.
+ * Afterwards primesieve_next_prime() returns the prime following
+ * the last prime of the block. The block is only valid until the
+ * next call of any other primesieve_iterator function.
+ */
+static inline const uint64_t* primesieve_next_prime_block(primesieve_iterator* it, size_t* size)
+{
+  size_t i = it->i + 1;
+  IF_UNLIKELY_PRIMESIEVE(i >= it->size)
+  {
+    primesieve_generate_next_primes(it);
+    i = 0;
+  }
+  *size = it->size - i;
+  it->i = it->size - 1;
+  return &it->primes[i];
+}
+
 /**
  * Get the previous prime.
  * primesieve_prev_prime(n) returns 0 for n <= 2.
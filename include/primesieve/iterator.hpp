@@ -93,14 +93,61 @@ struct iterator
   ///
   void clear() noexcept;
 
+  /// Enable or disable prefetch mode (disabled by default).
+  /// In prefetch mode next_prime() uses a background thread
+  /// which generates the next primes while you iterate over the
+  /// current primes. This hides most of the sieving work on a
+  /// spare CPU core, but it also uses an additional thread and
+  /// about twice as much memory. Prefetch mode is only used by
+  /// next_prime(), prev_prime() is always single-threaded.
+  ///
+  void set_prefetch(bool prefetch);
+
+  /// Set the max number of primes that next_prime() generates at
+  /// once (default 1024). Larger batches reduce the overhead per
+  /// prime of next_primes() and next_prime_block() which is useful
+  /// for vectorized code, but they use more memory. Batch sizes
+  /// < 64 are rounded up to 64. The new batch size is used after
+  /// the primes of the current segment have been consumed.
+  ///
+  void set_batch_size(std::size_t size);
+
+  /// Copy the next n primes into the primes array.
+  /// Same as calling next_prime() n times, but faster.
+  /// Throws a primesieve::primesieve_error exception (derived from
+  /// std::runtime_error) if any error occurs.
+  ///
+  void next_primes(uint64_t* primes, std::size_t n);
+
+  /// Get the next primes as a block of the internal primes array,
+  /// without copying them. Returns a pointer to the first prime of
+  /// the block and stores the number of primes (> 0) in *size.
+  /// Afterwards next_prime() returns the prime following the last
+  /// prime of the block. The block is only valid until the next
+  /// call of any other method of this primesieve::iterator.
+  ///
+  const uint64_t* next_prime_block(std::size_t* size)
+  {
+    std::size_t i = i_ + 1;
+    IF_UNLIKELY_PRIMESIEVE(i >= size_)
+    {
+      generate_next_primes();
+      i = 0;
+    }
+    *size = size_ - i;
+    i_ = size_ - 1;
+    return &primes_[i];
+  }
+
   /// Used internally by next_prime().
   /// generate_next_primes() fills (overwrites) the primes array with
-  /// the next few primes (~ 2^10) that are larger than the current
-  /// largest prime in the primes array or with the primes >= start
-  /// if the primes array is empty.
+  /// the next few primes (~ batch size) that are larger than the
+  /// current largest prime in the primes array or with the primes
+  /// >= start if the primes array is empty.
   /// Note that this method also updates the i & size member variables
   /// of this primesieve::iterator struct. The size of the primes array
-  /// varies, but it is > 0 and usually close to 2^10.
+  /// varies, but it is > 0 and usually close to the batch size
+  /// (2^10 by default).
   ///
   void generate_next_primes();
 
@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <memory>
 #include <new>
+#include <type_traits>
 
 namespace {
 
@@ -59,6 +60,16 @@ public:
     return arr;
   }
 
+  T* data() noexcept
+  {
+    return array_;
+  }
+
+  const T* data() const noexcept
+  {
+    return array_;
+  }
+
   T* end() noexcept
   {
     return end_;
@@ -110,6 +121,17 @@ public:
       reserve_unchecked(n);
   }
 
+  /// Note that resize() does not default initialize
+  /// the memory of POD types like int, long.
+  void resize(std::size_t n)
+  {
+    static_assert(std::is_trivial<T>::value,
+                  "malloc_vector<T> only supports POD types!");
+
+    reserve(n);
+    end_ = array_ + n;
+  }
+
 private:
   T* array_ = nullptr;
   T* end_ = nullptr;
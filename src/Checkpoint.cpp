@@ -0,0 +1,294 @@
+///
+/// @file   Checkpoint.cpp
+/// @brief  Counting the primes inside a huge interval e.g.
+///         [10^19, 2 * 10^19] takes days even on a cluster. Without
+///         a checkpoint file an interrupted computation has to be
+///         restarted from scratch. With a checkpoint file
+///         ParallelSieve periodically saves the finished chunks
+///         and their counts so that the computation can later be
+///         resumed (primesieve --checkpoint=FILE --resume).
+///
+///         File format (all numbers are 64-bit little-endian):
+///         "PRIMECP1", start, stop, flags, chunk distance, chunks,
+///         6 counts, number of ranges, ranges of finished chunks
+///         (index of first and last chunk of each range).
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/Checkpoint.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/forward.hpp>
+#include <primesieve/macros.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/PrimeSieve.hpp>
+#include <primesieve/primesieve_error.hpp>
+#include <primesieve/Vector.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace {
+
+const char magic[8] = { 'P', 'R', 'I', 'M', 'E', 'C', 'P', '1' };
+
+void writeUint64(std::FILE* file, uint64_t n)
+{
+  unsigned char bytes[8];
+  for (int i = 0; i < 8; i++)
+    bytes[i] = (unsigned char) (n >> (i * 8));
+  std::fwrite(bytes, 1, 8, file);
+}
+
+bool readUint64(std::FILE* file, uint64_t& n)
+{
+  unsigned char bytes[8];
+  if (std::fread(bytes, 1, 8, file) != 8)
+    return false;
+
+  n = 0;
+  for (int i = 0; i < 8; i++)
+    n |= (uint64_t) bytes[i] << (i * 8);
+
+  return true;
+}
+
+} // namespace
+
+namespace primesieve {
+
+/// @resume: If true the checkpoint file is loaded, the
+///          computation must then be the same as the one
+///          that created the checkpoint file.
+///
+Checkpoint::Checkpoint(const std::string& filename, bool resume) :
+  filename_(filename),
+  isResume_(resume)
+{
+  counts_.fill(0);
+  if (isResume_)
+    load();
+}
+
+/// Initialize the checkpoint for counting the
+/// primes inside [start, stop] using the given
+/// number of chunks of size chunkDist.
+///
+void Checkpoint::init(uint64_t start,
+                      uint64_t stop,
+                      int flags,
+                      uint64_t chunkDist,
+                      uint64_t chunks)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  lastSave_ = std::chrono::steady_clock::now();
+  next_ = 0;
+
+  if (isResume_)
+  {
+    if (start != start_ ||
+        stop != stop_ ||
+        flags != flags_ ||
+        chunkDist != chunkDist_ ||
+        chunks != chunks_)
+      throw primesieve_error("checkpoint " + filename_ + " was created for a different computation");
+  }
+  else
+  {
+    start_ = start;
+    stop_ = stop;
+    flags_ = flags;
+    chunkDist_ = chunkDist;
+    chunks_ = chunks;
+    counts_.fill(0);
+    finished_.clear();
+    finished_.resize(ceilDiv(chunks, 64));
+    std::fill(finished_.begin(), finished_.end(), 0);
+    isResume_ = true;
+  }
+}
+
+bool Checkpoint::isFinished(uint64_t i) const
+{
+  return (finished_[i / 64] >> (i % 64)) & 1;
+}
+
+/// Get the next chunk that has not yet been sieved.
+/// Called by the threads of ParallelSieve, each chunk
+/// is handed out only once.
+///
+bool Checkpoint::nextChunk(uint64_t& i)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  while (next_ < chunks_ && isFinished(next_))
+    next_++;
+
+  if (next_ >= chunks_)
+    return false;
+
+  i = next_++;
+  return true;
+}
+
+uint64_t Checkpoint::getFinishedChunks() const
+{
+  return popcount(finished_.data(), finished_.size());
+}
+
+/// Called by the threads of ParallelSieve after they have
+/// sieved the ith chunk. Updates the checkpoint file every
+/// config::CHECKPOINT_SECONDS seconds.
+///
+void Checkpoint::finishChunk(uint64_t i, const counts_t& counts)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  ASSERT(i < chunks_);
+  ASSERT(!isFinished(i));
+  finished_[i / 64] |= 1ull << (i % 64);
+
+  for (std::size_t j = 0; j < counts_.size(); j++)
+    counts_[j] += counts[j];
+
+  auto now = std::chrono::steady_clock::now();
+  std::chrono::duration<double> seconds = now - lastSave_;
+
+  if (seconds.count() >= config::CHECKPOINT_SECONDS)
+  {
+    write();
+    lastSave_ = now;
+  }
+}
+
+void Checkpoint::save()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  write();
+  lastSave_ = std::chrono::steady_clock::now();
+}
+
+/// The checkpoint is first written to a temporary
+/// file which is then renamed. Hence a computation
+/// that is killed during write() never corrupts
+/// the previous checkpoint file.
+///
+void Checkpoint::write()
+{
+  // Ranges of adjacent finished chunks
+  Vector<uint64_t> ranges;
+
+  for (uint64_t i = 0; i < chunks_; i++)
+  {
+    if (isFinished(i))
+    {
+      if (ranges.empty() || ranges.back() + 1 != i)
+      {
+        ranges.push_back(i);
+        ranges.push_back(i);
+      }
+      else
+        ranges.back() = i;
+    }
+  }
+
+  std::string tmpFilename = filename_ + ".tmp";
+  std::FILE* file = std::fopen(tmpFilename.c_str(), "wb");
+  if (!file)
+    throw primesieve_error("failed to create checkpoint: " + tmpFilename);
+
+  std::fwrite(magic, 1, 8, file);
+  writeUint64(file, start_);
+  writeUint64(file, stop_);
+  writeUint64(file, (uint64_t) flags_);
+  writeUint64(file, chunkDist_);
+  writeUint64(file, chunks_);
+  for (uint64_t count : counts_)
+    writeUint64(file, count);
+  writeUint64(file, ranges.size() / 2);
+  for (uint64_t n : ranges)
+    writeUint64(file, n);
+
+  bool isError = std::ferror(file) != 0;
+  isError |= std::fclose(file) != 0;
+
+  if (!isError)
+  {
+    // std::rename() fails on Windows if filename exists
+    std::remove(filename_.c_str());
+    isError = std::rename(tmpFilename.c_str(), filename_.c_str()) != 0;
+  }
+
+  if (isError)
+  {
+    std::remove(tmpFilename.c_str());
+    throw primesieve_error("failed to write checkpoint: " + filename_);
+  }
+}
+
+void Checkpoint::load()
+{
+  std::FILE* file = std::fopen(filename_.c_str(), "rb");
+  if (!file)
+    throw primesieve_error("failed to open checkpoint: " + filename_);
+
+  char bytes[8];
+  uint64_t flags = 0;
+  uint64_t ranges = 0;
+  bool isValid = std::fread(bytes, 1, 8, file) == 8 &&
+                 std::equal(bytes, bytes + 8, magic) &&
+                 readUint64(file, start_) &&
+                 readUint64(file, stop_) &&
+                 readUint64(file, flags) &&
+                 readUint64(file, chunkDist_) &&
+                 readUint64(file, chunks_) &&
+                 start_ <= stop_ &&
+                 chunkDist_ > 0 &&
+                 chunks_ > 0 &&
+                 chunks_ - 1 <= (stop_ - start_) / chunkDist_;
+
+  for (std::size_t i = 0; isValid && i < counts_.size(); i++)
+    isValid = readUint64(file, counts_[i]);
+
+  if (isValid &&
+      readUint64(file, ranges))
+  {
+    flags_ = (int) flags;
+    finished_.resize(ceilDiv(chunks_, 64));
+    std::fill(finished_.begin(), finished_.end(), 0);
+    uint64_t next = 0;
+
+    for (uint64_t i = 0; isValid && i < ranges; i++)
+    {
+      uint64_t first;
+      uint64_t last;
+      isValid = readUint64(file, first) &&
+                readUint64(file, last) &&
+                first >= next &&
+                first <= last &&
+                last < chunks_;
+
+      for (uint64_t j = first; isValid && j <= last; j++)
+        finished_[j / 64] |= 1ull << (j % 64);
+
+      next = last + 1;
+    }
+
+    isValid = isValid && std::fgetc(file) == EOF;
+  }
+  else
+    isValid = false;
+
+  std::fclose(file);
+
+  if (!isValid)
+    throw primesieve_error("invalid checkpoint file: " + filename_);
+}
+
+} // namespace
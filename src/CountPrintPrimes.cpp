@@ -15,17 +15,45 @@
 #include <primesieve/CountPrintPrimes.hpp>
 #include <primesieve/Erat.hpp>
 #include <primesieve/forward.hpp>
+#include <primesieve/intrinsics.hpp>
 #include <primesieve/littleendian_cast.hpp>
 #include <primesieve/macros.hpp>
 #include <primesieve/pmath.hpp>
 #include <primesieve/PreSieve.hpp>
 #include <primesieve/PrimeSieve.hpp>
+#include <primesieve/PrintBuffer.hpp>
+#include <primesieve/primesieve_error.hpp>
 #include <primesieve/SievingPrimes.hpp>
 
 #include <stdint.h>
 #include <algorithm>
-#include <iostream>
+#include <cstddef>
 #include <sstream>
+#include <string>
+
+#if defined(__AVX512F__) && \
+    defined(__AVX512VPOPCNTDQ__) && \
+    __has_include(<immintrin.h>)
+  #include <immintrin.h>
+  #define ENABLE_AVX512_VPOPCNT
+#else
+  #if defined(ENABLE_MULTIARCH_AVX512_VPOPCNT) && \
+      __has_include(<immintrin.h>)
+    #include <primesieve/cpu_supports_avx512_vpopcnt.hpp>
+    #include <immintrin.h>
+    #define ENABLE_AVX512_VPOPCNT
+  #endif
+  #if defined(__AVX2__) && \
+      __has_include(<immintrin.h>)
+    #include <immintrin.h>
+    #define ENABLE_AVX2
+  #elif defined(ENABLE_MULTIARCH_AVX2) && \
+        __has_include(<immintrin.h>)
+    #include <primesieve/cpu_supports_avx2.hpp>
+    #include <immintrin.h>
+    #define ENABLE_AVX2
+  #endif
+#endif
 
 namespace {
 
@@ -39,56 +67,331 @@ const uint64_t bitmasks[6][5] =
   { 0x3f, ~0ull }                    // Prime sextuplets: b00111111
 };
 
+/// Each bit of the sieve array corresponds to an integer that is
+/// not divisible by 2, 3 and 5. The 8 bits of each byte correspond
+/// to the offsets { 7, 11, 13, 17, 19, 23, 29, 31 }. A prime
+/// k-tuplet corresponds to k consecutive 1 bits inside the same
+/// byte, hence after computing t_k = w & (w >> 1) & ... & (w >> k-1)
+/// the k-tuplets correspond to the 1 bits of t_k at the bit
+/// positions below. Since none of these bit positions reads bits
+/// from the next byte, we can process 8 bytes at once (SWAR).
+///
+/// Twin primes:        t2 & b01001010
+/// Prime triplets:     t3 & b00001111
+/// Prime quadruplets:  t4 & b00000010
+/// Prime quintuplets:  t5 & b00000011
+/// Prime sextuplets:   t6 & b00000001
+///
+const uint64_t kTupletMasks[6] =
+{
+  0,                     // Prime numbers, unused
+  0x4a4a4a4a4a4a4a4aull, // Twin primes
+  0x0f0f0f0f0f0f0f0full, // Prime triplets
+  0x0202020202020202ull, // Prime quadruplets
+  0x0303030303030303ull, // Prime quintuplets
+  0x0101010101010101ull  // Prime sextuplets
+};
+
+/// Count all prime k-tuplets (twins, triplets, ...)
+/// of sieve[i] with i < size in a single pass.
+///
+void countkTuplets_default(const uint64_t* sieve,
+                           std::size_t i,
+                           std::size_t size,
+                           uint64_t* counts)
+{
+  for (; i < size; i++)
+  {
+    uint64_t bits = sieve[i];
+    uint64_t t = bits & (bits >> 1);
+    counts[1] += popcnt64(t & kTupletMasks[1]);
+    t &= bits >> 2;
+    counts[2] += popcnt64(t & kTupletMasks[2]);
+    t &= bits >> 3;
+    counts[3] += popcnt64(t & kTupletMasks[3]);
+    t &= bits >> 4;
+    counts[4] += popcnt64(t & kTupletMasks[4]);
+    t &= bits >> 5;
+    counts[5] += popcnt64(t & kTupletMasks[5]);
+  }
+}
+
+#if defined(ENABLE_AVX512_VPOPCNT)
+
+/// We don't use _mm512_reduce_add_epi64() because it causes
+/// -Wmaybe-uninitialized warnings with GCC. For the same reason
+/// countkTuplets_avx512() uses _mm512_maskz_srli_epi64() with
+/// all mask bits set instead of _mm512_srli_epi64().
+///
+#if !defined(__AVX512VPOPCNTDQ__)
+  __attribute__ ((target ("avx512f")))
+#endif
+uint64_t reduce_add_avx512(__m512i vect)
+{
+  uint64_t sum[8];
+  _mm512_storeu_si512(sum, vect);
+  return sum[0] + sum[1] + sum[2] + sum[3] +
+         sum[4] + sum[5] + sum[6] + sum[7];
+}
+
+/// Same algorithm as countkTuplets_default() but
+/// processes 8 64-bit words per loop iteration.
+///
+#if !defined(__AVX512VPOPCNTDQ__)
+  __attribute__ ((target ("avx512f,avx512vpopcntdq")))
+#endif
+void countkTuplets_avx512(const uint64_t* sieve,
+                          std::size_t size,
+                          uint64_t* counts)
+{
+  __m512i mask1 = _mm512_set1_epi64(kTupletMasks[1]);
+  __m512i mask2 = _mm512_set1_epi64(kTupletMasks[2]);
+  __m512i mask3 = _mm512_set1_epi64(kTupletMasks[3]);
+  __m512i mask4 = _mm512_set1_epi64(kTupletMasks[4]);
+  __m512i mask5 = _mm512_set1_epi64(kTupletMasks[5]);
+  __m512i sum1 = _mm512_setzero_si512();
+  __m512i sum2 = _mm512_setzero_si512();
+  __m512i sum3 = _mm512_setzero_si512();
+  __m512i sum4 = _mm512_setzero_si512();
+  __m512i sum5 = _mm512_setzero_si512();
+
+  for (std::size_t i = 0; i < size; i += 8)
+  {
+    // Load at most 8 words, the other words are zeroed
+    __mmask8 mask = (__mmask8) (0xff >> (8 - std::min<std::size_t>(size - i, 8)));
+    __m512i bits = _mm512_maskz_loadu_epi64(mask, &sieve[i]);
+    __m512i t = _mm512_and_si512(bits, _mm512_maskz_srli_epi64(0xff, bits, 1));
+    sum1 = _mm512_add_epi64(sum1, _mm512_popcnt_epi64(_mm512_and_si512(t, mask1)));
+    t = _mm512_and_si512(t, _mm512_maskz_srli_epi64(0xff, bits, 2));
+    sum2 = _mm512_add_epi64(sum2, _mm512_popcnt_epi64(_mm512_and_si512(t, mask2)));
+    t = _mm512_and_si512(t, _mm512_maskz_srli_epi64(0xff, bits, 3));
+    sum3 = _mm512_add_epi64(sum3, _mm512_popcnt_epi64(_mm512_and_si512(t, mask3)));
+    t = _mm512_and_si512(t, _mm512_maskz_srli_epi64(0xff, bits, 4));
+    sum4 = _mm512_add_epi64(sum4, _mm512_popcnt_epi64(_mm512_and_si512(t, mask4)));
+    t = _mm512_and_si512(t, _mm512_maskz_srli_epi64(0xff, bits, 5));
+    sum5 = _mm512_add_epi64(sum5, _mm512_popcnt_epi64(_mm512_and_si512(t, mask5)));
+  }
+
+  counts[1] += reduce_add_avx512(sum1);
+  counts[2] += reduce_add_avx512(sum2);
+  counts[3] += reduce_add_avx512(sum3);
+  counts[4] += reduce_add_avx512(sum4);
+  counts[5] += reduce_add_avx512(sum5);
+}
+
+#endif
+
+#if defined(ENABLE_AVX2)
+
+#if !defined(__AVX2__)
+  __attribute__ ((target ("avx2")))
+#endif
+uint64_t reduce_add_avx2(__m256i vect)
+{
+  __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(vect),
+                              _mm256_extracti128_si256(vect, 1));
+  return (uint64_t) _mm_cvtsi128_si64(sum) +
+         (uint64_t) _mm_extract_epi64(sum, 1);
+}
+
+/// AVX2 does not have a vector popcount instruction, hence we
+/// count the 1 bits of each nibble using a 16 entries lookup
+/// table (VPSHUFB) and then sum up the bytes of each 64-bit
+/// word using VPSADBW (Wojciech Muła's algorithm).
+///
+#if !defined(__AVX2__)
+  __attribute__ ((target ("avx2")))
+#endif
+__m256i popcnt_avx2(__m256i vect)
+{
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low4 = _mm256_set1_epi8(0x0f);
+  __m256i lo = _mm256_and_si256(vect, low4);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(vect, 4), low4);
+  __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+}
+
+/// Same algorithm as countkTuplets_default() but
+/// processes 4 64-bit words per loop iteration.
+///
+#if !defined(__AVX2__)
+  __attribute__ ((target ("avx2")))
+#endif
+void countkTuplets_avx2(const uint64_t* sieve,
+                        std::size_t size,
+                        uint64_t* counts)
+{
+  __m256i mask1 = _mm256_set1_epi64x((long long) kTupletMasks[1]);
+  __m256i mask2 = _mm256_set1_epi64x((long long) kTupletMasks[2]);
+  __m256i mask3 = _mm256_set1_epi64x((long long) kTupletMasks[3]);
+  __m256i mask4 = _mm256_set1_epi64x((long long) kTupletMasks[4]);
+  __m256i mask5 = _mm256_set1_epi64x((long long) kTupletMasks[5]);
+  __m256i sum1 = _mm256_setzero_si256();
+  __m256i sum2 = _mm256_setzero_si256();
+  __m256i sum3 = _mm256_setzero_si256();
+  __m256i sum4 = _mm256_setzero_si256();
+  __m256i sum5 = _mm256_setzero_si256();
+  std::size_t i = 0;
+
+  for (; i + 4 <= size; i += 4)
+  {
+    __m256i bits = _mm256_loadu_si256((const __m256i*) &sieve[i]);
+    __m256i t = _mm256_and_si256(bits, _mm256_srli_epi64(bits, 1));
+    sum1 = _mm256_add_epi64(sum1, popcnt_avx2(_mm256_and_si256(t, mask1)));
+    t = _mm256_and_si256(t, _mm256_srli_epi64(bits, 2));
+    sum2 = _mm256_add_epi64(sum2, popcnt_avx2(_mm256_and_si256(t, mask2)));
+    t = _mm256_and_si256(t, _mm256_srli_epi64(bits, 3));
+    sum3 = _mm256_add_epi64(sum3, popcnt_avx2(_mm256_and_si256(t, mask3)));
+    t = _mm256_and_si256(t, _mm256_srli_epi64(bits, 4));
+    sum4 = _mm256_add_epi64(sum4, popcnt_avx2(_mm256_and_si256(t, mask4)));
+    t = _mm256_and_si256(t, _mm256_srli_epi64(bits, 5));
+    sum5 = _mm256_add_epi64(sum5, popcnt_avx2(_mm256_and_si256(t, mask5)));
+  }
+
+  counts[1] += reduce_add_avx2(sum1);
+  counts[2] += reduce_add_avx2(sum2);
+  counts[3] += reduce_add_avx2(sum3);
+  counts[4] += reduce_add_avx2(sum4);
+  counts[5] += reduce_add_avx2(sum5);
+
+  // Process the remaining 0 - 3 words
+  countkTuplets_default(sieve, i, size, counts);
+}
+
+#endif
+
 } // namespace
 
 namespace primesieve {
 
+/// Count all prime k-tuplets (twins, triplets, ...) of
+/// sieve[i] with i < size in a single pass and add them to
+/// counts[1] (twins), counts[2] (triplets), ...
+/// We use AVX512 VPOPCNTDQ or AVX2 if the CPU supports it.
+///
+void countAllkTuplets(const uint64_t* sieve,
+                      std::size_t size,
+                      uint64_t* counts)
+{
+  #if defined(__AVX512F__) && \
+      defined(__AVX512VPOPCNTDQ__)
+    countkTuplets_avx512(sieve, size, counts);
+  #else
+    #if defined(ENABLE_AVX512_VPOPCNT)
+      if (cpu_supports_avx512_vpopcnt)
+        countkTuplets_avx512(sieve, size, counts);
+      else
+    #endif
+    #if defined(__AVX2__) && \
+        defined(ENABLE_AVX2)
+      countkTuplets_avx2(sieve, size, counts);
+    #elif defined(ENABLE_AVX2)
+      if (cpu_supports_avx2)
+        countkTuplets_avx2(sieve, size, counts);
+      else
+        countkTuplets_default(sieve, 0, size, counts);
+    #else
+      countkTuplets_default(sieve, 0, size, counts);
+    #endif
+  #endif
+}
+
+/// Used for testing, count all prime k-tuplets using the
+/// given kernel. Returns false if the kernel has not been
+/// compiled or if it is not supported by the CPU.
+///
+bool countAllkTuplets(const uint64_t* sieve,
+                      std::size_t size,
+                      kTupletsKernel kernel,
+                      uint64_t* counts)
+{
+  switch (kernel)
+  {
+    case KTUPLETS_DEFAULT:
+      countkTuplets_default(sieve, 0, size, counts);
+      return true;
+
+    case KTUPLETS_AVX2:
+      #if defined(__AVX2__) && \
+          defined(ENABLE_AVX2)
+        countkTuplets_avx2(sieve, size, counts);
+        return true;
+      #elif defined(ENABLE_AVX2)
+        if (cpu_supports_avx2)
+        {
+          countkTuplets_avx2(sieve, size, counts);
+          return true;
+        }
+      #endif
+      return false;
+
+    case KTUPLETS_AVX512:
+      #if defined(__AVX512F__) && \
+          defined(__AVX512VPOPCNTDQ__)
+        countkTuplets_avx512(sieve, size, counts);
+        return true;
+      #elif defined(ENABLE_AVX512_VPOPCNT)
+        if (cpu_supports_avx512_vpopcnt)
+        {
+          countkTuplets_avx512(sieve, size, counts);
+          return true;
+        }
+      #endif
+      return false;
+  }
+
+  return false;
+}
+
 CountPrintPrimes::CountPrintPrimes(PrimeSieve& ps) :
   counts_(ps.getCounts()),
-  ps_(ps)
+  ps_(ps),
+  memoryPool_(ps.getMemoryPool())
 {
   uint64_t start = ps.getStart();
   uint64_t stop = ps.getStop();
+  uint64_t maxStop = ps.getMaxStop();
   uint64_t sieveSize = ps.getSieveSize();
   start = std::max<uint64_t>(start, 7);
 
-  ps.getPreSieve().init(start, stop);
-  Erat::init(start, stop, sieveSize, ps.getPreSieve(), memoryPool_);
+  if (ps.isFlag(PRINT_UINT32) &&
+      stop > 0xffffffffull)
+    throw primesieve_error("cannot print primes > 2^32 - 1 as uint32");
 
-  if (ps_.isCountkTuplets())
-    initCounts();
-}
-
-/// Initialize the lookup tables to count the number
-/// of twins, triplets, ... per byte
-///
-void CountPrintPrimes::initCounts()
-{
-  for (unsigned i = 1; i < counts_.size(); i++)
-  {
-    if (ps_.isCount(i))
-    {
-      kCounts_[i].resize(256);
-
-      for (uint64_t j = 0; j < 256; j++)
-      {
-        kCounts_[i][j] = 0;
-        for (auto* b = bitmasks[i]; *b <= j; b++)
-          if ((j & *b) == *b)
-            kCounts_[i][j]++;
-      }
-    }
-  }
+  // Reuse the buckets of the previous sieve() call
+  memoryPool_.reset();
+  ps.getPreSieve().init(start, stop);
+  Erat::init(start, stop, maxStop, sieveSize, ps.getPreSieve(), memoryPool_);
 }
 
 void CountPrintPrimes::sieve()
 {
   uint64_t sieveSize = ps_.getSieveSize();
-  SievingPrimes sievingPrimes(this, sieveSize, ps_.getPreSieve(), memoryPool_);
+  SievingPrimes sievingPrimes(this, sieveSize, ps_.getPreSieve(), memoryPool_, ps_.getSievingPrimesTable());
   uint64_t prime = sievingPrimes.next();
 
+  // The varint format stores the difference to the
+  // previous prime, the primes < 7 are printed by
+  // PrimeSieve::processSmallPrimes().
+  uint64_t prev = 0;
+  for (uint64_t p : { 2, 3, 5 })
+    if (p >= ps_.getStart() && p <= ps_.getStop())
+      prev = p;
+
+  PrintBuffer printBuffer(ps_.getFlags(), prev, ps_.getPrintOutput());
+
   while (hasNextSegment())
   {
+    // If the next chunk of this thread is adjacent to the
+    // current chunk, we continue sieving without
+    // re-initializing the sieving primes.
+    while (segmentHigh_ >= stop_ &&
+           ps_.nextChunk())
+      extendStop(ps_.getStop());
+
     low_ = segmentLow_;
     uint64_t sqrtHigh = isqrt(segmentHigh_);
 
@@ -99,12 +402,13 @@ void CountPrintPrimes::sieve()
 
     if (ps_.isCountPrimes())
       countPrimes();
+
     if (ps_.isCountkTuplets())
       countkTuplets();
     if (ps_.isPrintPrimes())
-      printPrimes();
+      printPrimes(printBuffer);
     if (ps_.isPrintkTuplets())
-      printkTuplets();
+      printkTuplets(printBuffer);
     if (ps_.isStatus())
       ps_.updateStatus(sieve_.size() * 30);
   }
@@ -117,57 +421,46 @@ void CountPrintPrimes::countPrimes()
   counts_[0] += popcount((const uint64_t*) sieve_.data(), size);
 }
 
+/// Count all prime k-tuplets (twins, triplets, ...) of the
+/// current segment in a single pass over the sieve array.
+///
 void CountPrintPrimes::countkTuplets()
 {
+  ASSERT(sieve_.capacity() % sizeof(uint64_t) == 0);
+  auto* sieve = (const uint64_t*) sieve_.data();
+  std::size_t size = ceilDiv(sieve_.size(), 8);
+  uint64_t counts[6] = { 0, 0, 0, 0, 0, 0 };
+  countAllkTuplets(sieve, size, counts);
+
   // i = 1 twins, i = 2 triplets, ...
   for (unsigned i = 1; i < counts_.size(); i++)
-  {
     if (ps_.isCount(i))
-    {
-      ASSERT(sieve_.capacity() % 4 == 0);
-      auto* sieve = sieve_.data();
-      uint64_t sum = 0;
-
-      for (std::size_t j = 0; j < sieve_.size(); j += 4)
-      {
-        sum += kCounts_[i][sieve[j+0]];
-        sum += kCounts_[i][sieve[j+1]];
-        sum += kCounts_[i][sieve[j+2]];
-        sum += kCounts_[i][sieve[j+3]];
-      }
-
-      counts_[i] += sum;
-    }
-  }
+      counts_[i] += counts[i];
 }
 
 /// Print primes to stdout
-void CountPrintPrimes::printPrimes() const
+void CountPrintPrimes::printPrimes(PrintBuffer& printBuffer) const
 {
-  uint64_t low = low_;
-  std::size_t i = 0;
-
-  while (i < sieve_.size())
+  if (printBuffer.getFormat() == PRINT_BITMAP)
   {
-    std::size_t size = i + (1 << 16);
-    size = std::min(size, sieve_.size());
-    std::ostringstream primes;
+    printBuffer.write(sieve_.data(), sieve_.size());
+    return;
+  }
 
-    for (; i < size; i += 8)
-    {
-      uint64_t bits = littleendian_cast<uint64_t>(&sieve_[i]);
-      for (; bits != 0; bits &= bits - 1)
-        primes << nextPrime(bits, low) << '\n';
+  uint64_t low = low_;
 
-      low += 8 * 30;
-    }
+  for (std::size_t i = 0; i < sieve_.size(); i += 8)
+  {
+    uint64_t bits = littleendian_cast<uint64_t>(&sieve_[i]);
+    for (; bits != 0; bits &= bits - 1)
+      printBuffer.print(nextPrime(bits, low));
 
-    std::cout << primes.str();
+    low += 8 * 30;
   }
 }
 
 /// Print prime k-tuplets to stdout
-void CountPrintPrimes::printkTuplets() const
+void CountPrintPrimes::printkTuplets(PrintBuffer& printBuffer) const
 {
   // i = 1 twins, i = 2 triplets, ...
   unsigned i = 1;
@@ -196,7 +489,9 @@ void CountPrintPrimes::printkTuplets() const
     }
   }
 
-  std::cout << kTuplets.str();
+  std::string str = kTuplets.str();
+  if (!str.empty())
+    printBuffer.write(str.data(), str.size());
 }
 
 } // namespace
@@ -44,7 +44,9 @@
     defined(_M_IX86) || \
     defined(_M_X64)
   #include <primesieve/cpuid.hpp>
+  #include <primesieve/cpu_supports_avx2.hpp>
   #include <primesieve/cpu_supports_avx512_vbmi2.hpp>
+  #include <primesieve/cpu_supports_avx512_vpopcnt.hpp>
   #define HAS_CPUID
 #endif
 
@@ -392,6 +394,12 @@ void CpuInfo::init()
 #include <set>
 #include <sstream>
 
+#if defined(__linux__) && \
+    __has_include(<sched.h>)
+  #include <sched.h>
+  #define HAS_SCHED_GETAFFINITY
+#endif
+
 using namespace primesieve;
 
 namespace {
@@ -546,9 +554,9 @@ std::vector<std::string> split(const std::string& str,
 /// Example: 0-8,18-26
 /// https://www.kernel.org/doc/Documentation/cputopology.txt
 ///
-size_t parseThreadList(const std::string& filename)
+std::vector<size_t> parseThreadIds(const std::string& filename)
 {
-  std::size_t threads = 0;
+  std::vector<size_t> threadIds;
   auto threadList = getString(filename);
   auto tokens = split(threadList, ',');
 
@@ -556,16 +564,22 @@ size_t parseThreadList(const std::string& filename)
   {
     auto values = split(str, '-');
     if (values.size() == 1)
-      threads++;
+      threadIds.push_back(std::stoul(values.at(0)));
     else
     {
       auto t0 = std::stoul(values.at(0));
       auto t1 = std::stoul(values.at(1));
-      threads += t1 - t0 + 1;
+      for (auto t = t0; t <= t1; t++)
+        threadIds.push_back(t);
     }
   }
 
-  return threads;
+  return threadIds;
+}
+
+size_t parseThreadList(const std::string& filename)
+{
+  return parseThreadIds(filename).size();
 }
 
 /// A thread map file contains a hexadecimal
@@ -611,6 +625,121 @@ size_t getThreads(const std::string& threadList,
     return parseThreadMap(threadMap);
 }
 
+/// Number of CPU cores of the process' affinity
+/// mask (e.g. taskset, docker --cpuset-cpus).
+/// Returns 0 if unknown.
+///
+size_t getAffinityCpuCores()
+{
+#if defined(HAS_SCHED_GETAFFINITY)
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0)
+    return (size_t) CPU_COUNT(&cpus);
+#endif
+
+  return 0;
+}
+
+/// Read the CPU quota (in CPU cores) of a cgroup directory.
+/// cgroup v2: cpu.max contains "$QUOTA $PERIOD" or "max $PERIOD".
+/// cgroup v1: cpu.cfs_quota_us and cpu.cfs_period_us, a
+/// quota of -1 means there is no quota.
+/// Returns 0 if there is no quota.
+///
+double getCgroupQuota(const std::string& path)
+{
+  std::string quota;
+  double period = 0;
+  std::ifstream cpuMax(path + "/cpu.max");
+
+  if (cpuMax)
+    cpuMax >> quota >> period;
+  else
+  {
+    quota = getString(path + "/cpu.cfs_quota_us");
+    std::ifstream cfsPeriod(path + "/cpu.cfs_period_us");
+    cfsPeriod >> period;
+  }
+
+  if (quota.empty() ||
+      quota == "max" ||
+      quota.at(0) == '-' ||
+      period <= 0)
+    return 0;
+
+  try
+  {
+    return std::stod(quota) / period;
+  }
+  catch (std::exception&)
+  {
+    return 0;
+  }
+}
+
+/// Get the CPU quota (in CPU cores) of the process' cgroup
+/// e.g. inside a Docker container or a Kubernetes pod.
+/// A quota may be set at any level of the cgroup hierarchy,
+/// hence we return the smallest quota of the process'
+/// cgroup and its ancestors. Returns 0 if there is no quota.
+/// https://docs.kernel.org/admin-guide/cgroup-v2.html
+///
+double getCpuQuota()
+{
+  double minQuota = 0;
+  std::ifstream file("/proc/self/cgroup");
+  std::string line;
+
+  // Line format: hierarchy-ID:controller-list:cgroup-path
+  // cgroup v2: 0::/user.slice
+  // cgroup v1: 4:cpu,cpuacct:/docker/1d2b3c
+  while (std::getline(file, line))
+  {
+    auto tokens = split(line, ':');
+    if (tokens.size() < 3)
+      continue;
+
+    std::string root;
+    auto controllers = split(tokens[1], ',');
+
+    if (tokens[0] == "0" && tokens[1].empty())
+      root = "/sys/fs/cgroup";
+    else if (std::find(controllers.begin(), controllers.end(), "cpu") != controllers.end())
+    {
+      root = "/sys/fs/cgroup/" + tokens[1];
+      if (!std::ifstream(root + "/cpu.cfs_quota_us"))
+        root = "/sys/fs/cgroup/cpu";
+    }
+    else
+      continue;
+
+    // Inside a container without cgroup namespace the
+    // cgroup path is relative to the host's root cgroup
+    // and it does not exist, hence we also try
+    // all ancestor directories.
+    std::string path = tokens[2];
+
+    while (true)
+    {
+      while (!path.empty() && path.back() == '/')
+        path.pop_back();
+
+      double quota = getCgroupQuota(root + path);
+      if (quota > 0 && (minQuota == 0 || quota < minQuota))
+        minQuota = quota;
+
+      std::size_t pos = path.find_last_of('/');
+      if (path.empty() || pos == std::string::npos)
+        break;
+
+      path.erase(pos);
+    }
+  }
+
+  return minQuota;
+}
+
 } // namespace
 
 namespace primesieve {
@@ -619,6 +748,19 @@ void CpuInfo::init()
 {
   std::string cpusOnline = "/sys/devices/system/cpu/online";
   logicalCpuCores_ = parseThreadList(cpusOnline);
+  affinityCpuCores_ = getAffinityCpuCores();
+  cpuQuota_ = getCpuQuota();
+
+  // NUMA nodes may not be numbered contiguously
+  std::string nodesOnline = "/sys/devices/system/node/online";
+  for (std::size_t node : parseThreadIds(nodesOnline))
+  {
+    std::string cpuList = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+    auto cpus = parseThreadIds(cpuList);
+    if (!cpus.empty())
+      numaNodeCpus_.push_back(cpus);
+  }
+
   bool identicalL1CacheSizes = false;
 
   using CacheSize_t = std::size_t;
@@ -721,6 +863,8 @@ const CpuInfo cpuInfo;
 
 CpuInfo::CpuInfo() :
   logicalCpuCores_(0),
+  affinityCpuCores_(0),
+  cpuQuota_(0),
   cacheSizes_{0, 0, 0, 0},
   cacheSharing_{0, 0, 0, 0}
 {
@@ -755,6 +899,15 @@ std::string CpuInfo::cpuName() const
   }
 }
 
+bool CpuInfo::hasAVX2() const
+{
+  #if defined(HAS_CPUID)
+    return cpu_supports_avx2;
+  #else
+    return false;
+  #endif
+}
+
 bool CpuInfo::hasAVX512() const
 {
   #if defined(HAS_CPUID)
@@ -764,6 +917,15 @@ bool CpuInfo::hasAVX512() const
   #endif
 }
 
+bool CpuInfo::hasAVX512VPOPCNT() const
+{
+  #if defined(HAS_CPUID)
+    return cpu_supports_avx512_vpopcnt;
+  #else
+    return false;
+  #endif
+}
+
 size_t CpuInfo::logicalCpuCores() const
 {
   return logicalCpuCores_;
@@ -799,6 +961,55 @@ size_t CpuInfo::l3Sharing() const
   return cacheSharing_[3];
 }
 
+size_t CpuInfo::affinityCpuCores() const
+{
+  return affinityCpuCores_;
+}
+
+double CpuInfo::cpuQuota() const
+{
+  return cpuQuota_;
+}
+
+/// Number of CPU cores the process may use: the minimum of
+/// the logical CPU cores, the CPU cores of the process'
+/// affinity mask and the cgroup CPU quota (rounded down,
+/// using more threads than the quota causes throttling).
+/// Returns 0 if unknown.
+///
+size_t CpuInfo::availableCpuCores() const
+{
+  std::size_t cores = 0;
+
+  if (hasLogicalCpuCores())
+    cores = logicalCpuCores_;
+
+  if (hasAffinityCpuCores() &&
+      (cores == 0 || affinityCpuCores_ < cores))
+    cores = affinityCpuCores_;
+
+  if (hasCpuQuota())
+  {
+    std::size_t quota = std::max<std::size_t>(1, (std::size_t) cpuQuota_);
+    if (cores == 0 || quota < cores)
+      cores = quota;
+  }
+
+  return cores;
+}
+
+/// Number of NUMA nodes that have CPUs
+size_t CpuInfo::numaNodes() const
+{
+  return numaNodeCpus_.size();
+}
+
+/// IDs of the logical CPU cores of the NUMA node
+const std::vector<size_t>& CpuInfo::numaNodeCpus(std::size_t node) const
+{
+  return numaNodeCpus_.at(node);
+}
+
 std::string CpuInfo::getError() const
 {
   return error_;
@@ -814,6 +1025,23 @@ bool CpuInfo::hasLogicalCpuCores() const
          logicalCpuCores_ <= (1 << 20);
 }
 
+bool CpuInfo::hasAffinityCpuCores() const
+{
+  return affinityCpuCores_ >= 1 &&
+         affinityCpuCores_ <= (1 << 20);
+}
+
+bool CpuInfo::hasCpuQuota() const
+{
+  return cpuQuota_ > 0 &&
+         cpuQuota_ <= (1 << 20);
+}
+
+bool CpuInfo::hasNumaNodes() const
+{
+  return !numaNodeCpus_.empty();
+}
+
 bool CpuInfo::hasL1Cache() const
 {
   return cacheSizes_[1] >= (1 << 12) &&
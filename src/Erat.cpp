@@ -15,11 +15,13 @@
 #include <primesieve/EratSmall.hpp>
 #include <primesieve/EratMedium.hpp>
 #include <primesieve/EratBig.hpp>
+#include <primesieve/EratTuning.hpp>
 #include <primesieve/PreSieve.hpp>
 #include <primesieve/macros.hpp>
 #include <primesieve/pmath.hpp>
 
 #include <stdint.h>
+#include <cstddef>
 #include <algorithm>
 #include <limits>
 
@@ -51,7 +53,8 @@ namespace primesieve {
 
 Erat::Erat(uint64_t start, uint64_t stop) :
   start_(start),
-  stop_(stop)
+  stop_(stop),
+  maxStop_(stop)
 { }
 
 /// @start: Sieve primes >= start.
@@ -64,17 +67,33 @@ void Erat::init(uint64_t start,
                 uint64_t maxSieveSize,
                 PreSieve& preSieve,
                 MemoryPool& memoryPool)
+{
+  init(start, stop, stop, maxSieveSize, preSieve, memoryPool);
+}
+
+/// Same as above, but the sieving algorithms are initialized
+/// for sieving up to maxStop. Hence we can later continue
+/// sieving up to maxStop using extendStop().
+///
+void Erat::init(uint64_t start,
+                uint64_t stop,
+                uint64_t maxStop,
+                uint64_t maxSieveSize,
+                PreSieve& preSieve,
+                MemoryPool& memoryPool)
 {
   if_unlikely(start > stop || 
               start >= std::numeric_limits<uint64_t>::max())
     return;
 
   ASSERT(start >= 7);
+  ASSERT(stop <= maxStop);
   ASSERT(maxSieveSize >= 16);
   ASSERT(maxSieveSize <= 8192);
 
   start_ = start;
   stop_ = stop;
+  maxStop_ = maxStop;
   preSieve_ = &preSieve;
   maxPreSieve_ = preSieve_->getMaxPrime();
 
@@ -101,8 +120,10 @@ uint64_t Erat::getL1CacheSize()
 void Erat::initAlgorithms(uint64_t maxSieveSize,
                           MemoryPool& memoryPool)
 {
-  uint64_t sqrtStop = isqrt(stop_);
+  uint64_t sqrtStop = isqrt(maxStop_);
   uint64_t l1CacheSize = getL1CacheSize();
+  double factorEratSmall = getEratTuning().factorEratSmall;
+  double factorEratMedium = getEratTuning().factorEratMedium;
   l1CacheSize = inBetween(16 << 10, l1CacheSize, 8192 << 10);
 
   // ================================================================
@@ -134,8 +155,8 @@ void Erat::initAlgorithms(uint64_t maxSieveSize,
   // algorithm, medium sieving primes are processed using
   // the EratMedium algorithm and large sieving primes are
   // processed using the EratBig algorithm.
-  maxEratSmall_ = (uint64_t) (minSieveSize * config::FACTOR_ERATSMALL);
-  maxEratMedium_ = (uint64_t) (sieveSize * config::FACTOR_ERATMEDIUM);
+  maxEratSmall_ = (uint64_t) (minSieveSize * factorEratSmall);
+  maxEratMedium_ = (uint64_t) (sieveSize * factorEratMedium);
 
   // ================================================================
   // 4. EratBig requires a power of 2 sieve size
@@ -145,14 +166,17 @@ void Erat::initAlgorithms(uint64_t maxSieveSize,
   {
     sieveSize = floorPow2(sieveSize);
     minSieveSize = std::min(l1CacheSize, sieveSize);
-    maxEratSmall_ = (uint64_t) (minSieveSize * config::FACTOR_ERATSMALL);
-    maxEratMedium_ = (uint64_t) (sieveSize * config::FACTOR_ERATMEDIUM);
+    maxEratSmall_ = (uint64_t) (minSieveSize * factorEratSmall);
+    maxEratMedium_ = (uint64_t) (sieveSize * factorEratMedium);
   }
 
   // ================================================================
   // 5. Ensure we allocate the smallest possible amount of memory
   // ================================================================
 
+  // The tuning factors are runtime parameters,
+  // ensure that maxEratSmall <= maxEratMedium.
+  maxEratMedium_ = std::max(maxEratMedium_, maxEratSmall_);
   maxEratSmall_ = std::min(maxEratSmall_, sqrtStop);
   maxEratMedium_ = std::min(maxEratMedium_, sqrtStop);
 
@@ -178,7 +202,7 @@ void Erat::initAlgorithms(uint64_t maxSieveSize,
   // If we are sieving just a single segment
   // and the EratBig algorithm is not used, then
   // we can allocate a smaller sieve array.
-  if (segmentHigh_ >= stop_ &&
+  if (segmentHigh_ >= maxStop_ &&
       sqrtStop <= maxEratMedium_)
   {
     uint64_t rem = byteRemainder(stop_);
@@ -193,13 +217,31 @@ void Erat::initAlgorithms(uint64_t maxSieveSize,
 
   ASSERT(sieveSize % sizeof(uint64_t) == 0);
   sieve_.resize(sieveSize);
+  l1CacheSize_ = (std::size_t) l1CacheSize;
 
   if (sqrtStop > maxPreSieve_)
-    eratSmall_.init(stop_, l1CacheSize, maxEratSmall_);
+    eratSmall_.init(maxStop_, l1CacheSize, maxEratSmall_);
   if (sqrtStop > maxEratSmall_)
-    eratMedium_.init(stop_, maxEratMedium_, memoryPool);
+    eratMedium_.init(maxStop_, maxEratMedium_, memoryPool);
   if (sqrtStop > maxEratMedium_)
-    eratBig_.init(stop_, sieve_.size(), sqrtStop, memoryPool);
+    eratBig_.init(maxStop_, sieve_.size(), sqrtStop, memoryPool);
+}
+
+/// Continue sieving up to the new stop number. The sieving
+/// primes and their next multiples are kept, hence sieving
+/// [start, stop] is then identical to sieving [start_, stop].
+/// @pre The last segment has not yet been sieved.
+///
+void Erat::extendStop(uint64_t stop)
+{
+  ASSERT(hasNextSegment());
+  ASSERT(stop > stop_);
+  ASSERT(stop <= maxStop_);
+
+  stop_ = stop;
+  uint64_t dist = sieve_.size() * 30 + 6;
+  segmentHigh_ = checkedAdd(segmentLow_, dist);
+  segmentHigh_ = std::min(segmentHigh_, stop_);
 }
 
 bool Erat::hasNextSegment() const
@@ -215,67 +257,83 @@ uint64_t Erat::byteRemainder(uint64_t n)
   return (n - 7) % 30 + 7;
 }
 
+/// Sieve the next segment. Pre-sieving and crossing off the
+/// multiples of small sieving primes (EratSmall) is done one
+/// L1 cache sized block at a time, so that the pre-sieved block
+/// is still in the L1 cache when EratSmall crosses off multiples.
+/// EratMedium and EratBig have few multiples per segment, hence
+/// they process the entire sieve array afterwards.
+///
 void Erat::sieveSegment()
 {
-  if (segmentHigh_ < stop_)
-  {
-    preSieve();
-    crossOff();
+  sieveBlocks();
 
-    uint64_t dist = sieve_.size() * 30;
-    segmentLow_ = checkedAdd(segmentLow_, dist);
-    segmentHigh_ = checkedAdd(segmentHigh_, dist);
-    segmentHigh_ = std::min(segmentHigh_, stop_);
-  }
-  else
-    sieveLastSegment();
+  if (eratMedium_.hasSievingPrimes())
+    eratMedium_.crossOff(sieve_);
+  if (eratBig_.hasSievingPrimes())
+    eratBig_.crossOff(sieve_);
+
+  nextSegment();
 }
 
-void Erat::sieveLastSegment()
+/// Pre-sieve and cross-off the multiples of small sieving
+/// primes of the current segment one L1 cache sized block
+/// at a time.
+///
+void Erat::sieveBlocks()
 {
   uint64_t rem = byteRemainder(stop_);
-  uint64_t dist = (stop_ - rem) - segmentLow_;
-  sieve_.resize(dist / 30 + 1);
-
-  preSieve();
-  crossOff();
+  bool isLastSegment = segmentHigh_ >= stop_;
 
-  // unset bits > stop
-  sieve_.back() &= unsetLarger[rem];
+  if (isLastSegment)
+  {
+    uint64_t dist = (stop_ - rem) - segmentLow_;
+    sieve_.resize(dist / 30 + 1);
+  }
 
-  // unset bytes > stop
-  auto* sieve = sieve_.data();
-  auto i = sieve_.size();
+  ASSERT(l1CacheSize_ % sizeof(uint64_t) == 0);
   ASSERT(sieve_.capacity() % sizeof(uint64_t) == 0);
-  for (; i % sizeof(uint64_t); i++)
-    sieve[i] = 0;
-
-  segmentLow_ = stop_;
-}
-
-/// Pre-sieve multiples of small primes < 100
-/// to speed up the sieve of Eratosthenes
-///
-void Erat::preSieve()
-{
-  preSieve_->preSieve(sieve_, segmentLow_);
 
-  // unset bits < start
-  if (segmentLow_ <= start_)
+  for (std::size_t i = 0; i < sieve_.size(); i += l1CacheSize_)
   {
-    uint64_t rem = byteRemainder(start_);
-    sieve_[0] &= unsetSmaller[rem];
+    std::size_t size = std::min(l1CacheSize_, sieve_.size() - i);
+    uint8_t* sieve = &sieve_[i];
+
+    // Pre-sieve multiples of small primes < 100
+    // to speed up the sieve of Eratosthenes
+    preSieve_->preSieve(sieve, size, segmentLow_ + i * 30);
+
+    // unset bits < start
+    if (i == 0 && segmentLow_ <= start_)
+      sieve[0] &= unsetSmaller[byteRemainder(start_)];
+
+    if (isLastSegment &&
+        i + size == sieve_.size())
+    {
+      // unset bits > stop
+      sieve[size - 1] &= unsetLarger[rem];
+
+      // unset bytes > stop
+      for (std::size_t j = size; (i + j) % sizeof(uint64_t); j++)
+        sieve[j] = 0;
+    }
+
+    if (eratSmall_.hasSievingPrimes())
+      eratSmall_.crossOff(sieve, size);
   }
 }
 
-void Erat::crossOff()
+void Erat::nextSegment()
 {
-  if (eratSmall_.hasSievingPrimes())
-    eratSmall_.crossOff(sieve_);
-  if (eratMedium_.hasSievingPrimes())
-    eratMedium_.crossOff(sieve_);
-  if (eratBig_.hasSievingPrimes())
-    eratBig_.crossOff(sieve_);
+  if (segmentHigh_ < stop_)
+  {
+    uint64_t dist = sieve_.size() * 30;
+    segmentLow_ = checkedAdd(segmentLow_, dist);
+    segmentHigh_ = checkedAdd(segmentHigh_, dist);
+    segmentHigh_ = std::min(segmentHigh_, stop_);
+  }
+  else
+    segmentLow_ = stop_;
 }
 
 } // namespace
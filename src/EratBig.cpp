@@ -175,7 +175,7 @@ void EratBig::storeSievingPrime(uint64_t prime,
     memoryPool_->addBucket(buckets_[segment]);
 }
 
-void EratBig::crossOff(Vector<uint8_t>& sieve)
+void EratBig::crossOff(SieveArray& sieve)
 {
   while (true)
   {
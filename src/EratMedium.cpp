@@ -65,7 +65,7 @@ void EratMedium::storeSievingPrime(uint64_t prime,
   buckets_[wheelIndex]++->set(sievingPrime, multipleIndex, wheelIndex);
 }
 
-void EratMedium::crossOff(Vector<uint8_t>& sieve)
+void EratMedium::crossOff(SieveArray& sieve)
 {
   currentBuckets_.swap(buckets_);
 
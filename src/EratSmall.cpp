@@ -63,7 +63,7 @@ void EratSmall::storeSievingPrime(uint64_t prime,
 /// @sieveSize:   EratBig & EratMedium sieve size
 /// @l1CacheSize: EratSmall sieve size
 ///
-void EratSmall::crossOff(Vector<uint8_t>& sieve)
+void EratSmall::crossOff(SieveArray& sieve)
 {
   for (std::size_t i = 0; i < sieve.size(); i += l1CacheSize_)
   {
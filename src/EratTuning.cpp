@@ -0,0 +1,60 @@
+///
+/// @file   EratTuning.cpp
+/// @brief  The thresholds between the EratSmall, EratMedium and
+///         EratBig algorithms. The defaults are FACTOR_ERATSMALL
+///         and FACTOR_ERATMEDIUM from config.hpp.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/EratTuning.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/primesieve_error.hpp>
+
+#include <string>
+
+namespace {
+
+using primesieve::EratTuning;
+
+EratTuning& eratTuning()
+{
+  static EratTuning tuning =
+  {
+    config::FACTOR_ERATSMALL,
+    config::FACTOR_ERATMEDIUM
+  };
+
+  return tuning;
+}
+
+void checkFactor(const std::string& name, double factor)
+{
+  // Larger factors cause a multipleIndex overflow
+  // in EratSmall and EratMedium (23-bits).
+  if (!(factor > 0 && factor <= 4.5))
+    throw primesieve::primesieve_error(name + " must be > 0 and <= 4.5");
+}
+
+} // namespace
+
+namespace primesieve {
+
+const EratTuning& getEratTuning()
+{
+  return eratTuning();
+}
+
+void setEratTuning(double factorEratSmall,
+                   double factorEratMedium)
+{
+  checkFactor("factorEratSmall", factorEratSmall);
+  checkFactor("factorEratMedium", factorEratMedium);
+  eratTuning().factorEratSmall = factorEratSmall;
+  eratTuning().factorEratMedium = factorEratMedium;
+}
+
+} // namespace
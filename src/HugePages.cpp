@@ -0,0 +1,193 @@
+///
+/// @file   HugePages.cpp
+/// @brief  For large sieving limits EratBig stores millions of
+///         sieving primes in buckets that are scattered over
+///         hundreds of megabytes of memory. Each segment accesses
+///         a different bucket list, hence with the default 4 KiB
+///         memory pages nearly each bucket access causes a TLB
+///         miss. Using 2 MiB huge pages the same memory is covered
+///         by 512x fewer TLB entries.
+///
+///         On Linux we first try to allocate explicit huge pages
+///         (MAP_HUGETLB) which requires that the administrator has
+///         reserved huge pages, e.g. using:
+///         echo 1024 > /proc/sys/vm/nr_hugepages
+///         If that fails we allocate 2 MiB aligned memory and ask
+///         the kernel to back it with transparent huge pages
+///         (madvise(MADV_HUGEPAGE)). If that fails as well (or on
+///         other operating systems) the HugePageAllocator falls
+///         back to the default allocator.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/HugePages.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/Vector.hpp>
+
+#include <stdint.h>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+#if defined(__linux__) && \
+    __has_include(<sys/mman.h>)
+  #include <sys/mman.h>
+  #define HAS_MMAP
+#endif
+
+namespace {
+
+std::atomic<bool> hugePages(false);
+
+#if defined(HAS_MMAP)
+
+struct Mapping
+{
+  void* ptr;
+  std::size_t bytes;
+};
+
+/// Memory mappings created by allocateHugePages()
+struct Mappings
+{
+  std::mutex mutex;
+  primesieve::Vector<Mapping> mappings;
+};
+
+Mappings& getMappings()
+{
+  // Never destroyed, as static arrays
+  // may be deallocated at exit.
+  static Mappings* mappings = new Mappings;
+  return *mappings;
+}
+
+void* mmapHugeTlb(std::size_t bytes)
+{
+#if defined(MAP_HUGETLB)
+  void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (ptr != MAP_FAILED)
+    return ptr;
+#else
+  (void) bytes;
+#endif
+
+  return nullptr;
+}
+
+/// Allocate 2 MiB aligned memory and
+/// enable transparent huge pages.
+///
+void* mmapTransparent(std::size_t bytes)
+{
+#if defined(MADV_HUGEPAGE)
+  std::size_t pageSize = config::HUGE_PAGE_SIZE;
+  std::size_t size = bytes + pageSize;
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+    return nullptr;
+
+  // Unmap the unaligned memory before and after
+  char* begin = (char*) ptr;
+  uintptr_t addr = ((uintptr_t) begin + pageSize - 1) & ~(uintptr_t) (pageSize - 1);
+  char* aligned = (char*) addr;
+  char* end = aligned + bytes;
+  if (aligned > begin)
+    munmap(begin, aligned - begin);
+  if (begin + size > end)
+    munmap(end, (begin + size) - end);
+
+  // Without transparent huge page support we may still
+  // use the memory, it is backed by normal pages.
+  madvise(aligned, bytes, MADV_HUGEPAGE);
+  return aligned;
+#else
+  (void) bytes;
+  return nullptr;
+#endif
+}
+
+#endif
+
+} // namespace
+
+namespace primesieve {
+
+bool isHugePages()
+{
+  return hugePages.load(std::memory_order_relaxed);
+}
+
+/// Only affects memory allocated afterwards
+void setHugePages(bool enable)
+{
+  hugePages.store(enable, std::memory_order_relaxed);
+}
+
+/// Returns nullptr if huge pages are not supported.
+/// The memory must be freed using deallocateHugePages().
+///
+void* allocateHugePages(std::size_t bytes)
+{
+#if defined(HAS_MMAP)
+  if (bytes == 0)
+    return nullptr;
+
+  bytes = ceilDiv(bytes, config::HUGE_PAGE_SIZE) * config::HUGE_PAGE_SIZE;
+  void* ptr = mmapHugeTlb(bytes);
+
+  if (!ptr)
+    ptr = mmapTransparent(bytes);
+
+  if (ptr)
+  {
+    Mappings& m = getMappings();
+    std::lock_guard<std::mutex> lock(m.mutex);
+    m.mappings.push_back(Mapping{ptr, bytes});
+  }
+
+  return ptr;
+#else
+  (void) bytes;
+  return nullptr;
+#endif
+}
+
+/// Returns false if ptr has not been
+/// allocated using allocateHugePages().
+///
+bool deallocateHugePages(void* ptr)
+{
+#if defined(HAS_MMAP)
+  if (!ptr)
+    return false;
+
+  Mappings& m = getMappings();
+  std::lock_guard<std::mutex> lock(m.mutex);
+  auto& mappings = m.mappings;
+
+  for (std::size_t i = 0; i < mappings.size(); i++)
+  {
+    if (mappings[i].ptr == ptr)
+    {
+      munmap(ptr, mappings[i].bytes);
+      mappings[i] = mappings.back();
+      mappings.resize(mappings.size() - 1);
+      return true;
+    }
+  }
+#else
+  (void) ptr;
+#endif
+
+  return false;
+}
+
+} // namespace
@@ -19,7 +19,9 @@
 #include <primesieve/MemoryPool.hpp>
 #include <primesieve/config.hpp>
 #include <primesieve/Bucket.hpp>
+#include <primesieve/HugePages.hpp>
 #include <primesieve/macros.hpp>
+#include <primesieve/pmath.hpp>
 #include <primesieve/Vector.hpp>
 #include <primesieve/primesieve_error.hpp>
 
@@ -73,6 +75,16 @@ void MemoryPool::allocateBuckets()
 
   // Allocate a large chunk of memory
   std::size_t bytes = count_ * sizeof(Bucket);
+
+  // Huge pages are only used for large allocations, we
+  // round up to whole huge pages as these are allocated
+  // anyway. Most buckets are allocated when sieving with
+  // large sieving primes and EratBig accesses these buckets
+  // randomly, hence there are many TLB misses otherwise.
+  if (isHugePages() &&
+      bytes >= config::HUGE_PAGE_SIZE / 2)
+    bytes = ceilDiv(bytes, config::HUGE_PAGE_SIZE) * config::HUGE_PAGE_SIZE;
+
   memory_.emplace_back(bytes);
   void* ptr = (void*) memory_.back().data();
 
@@ -81,29 +93,51 @@ void MemoryPool::allocateBuckets()
     throw primesieve_error("MemoryPool: failed to align memory!");
 
   count_ = bytes / sizeof(Bucket);
-  initBuckets(ptr);
+  initBuckets(ptr, count_);
 }
 
-void MemoryPool::initBuckets(void* alignedPtr)
+/// Add the buckets to the front of the stock
+void MemoryPool::initBuckets(void* alignedPtr, std::size_t count)
 {
   Bucket* buckets = (Bucket*) alignedPtr;
 
   if_unlikely((std::size_t) buckets % sizeof(Bucket) != 0)
     throw primesieve_error("MemoryPool: failed to align memory!");
-  if_unlikely(count_ < 10)
+  if_unlikely(count < 10)
     throw primesieve_error("MemoryPool: insufficient buckets allocated!");
 
-  for (std::size_t i = 0; i < count_ - 1; i++)
+  for (std::size_t i = 0; i < count - 1; i++)
   {
     buckets[i].reset();
     buckets[i].setNext(&buckets[i + 1]);
   }
 
-  buckets[count_ - 1].reset();
-  buckets[count_ - 1].setNext(nullptr);
+  buckets[count - 1].reset();
+  buckets[count - 1].setNext(stock_);
   stock_ = buckets;
 }
 
+/// Move all buckets back to the stock so that they can be
+/// reused without allocating new memory. Used by threads
+/// that sieve many chunks one after another.
+/// @pre None of the buckets are in use anymore.
+///
+void MemoryPool::reset()
+{
+  stock_ = nullptr;
+
+  for (auto& memory : memory_)
+  {
+    void* ptr = (void*) memory.data();
+    std::size_t bytes = memory.size();
+
+    if_unlikely(!std::align(sizeof(Bucket), sizeof(Bucket), ptr, bytes))
+      throw primesieve_error("MemoryPool: failed to align memory!");
+
+    initBuckets(ptr, bytes / sizeof(Bucket));
+  }
+}
+
 void MemoryPool::addBucket(SievingPrime*& sievingPrime)
 {
   if (!stock_)
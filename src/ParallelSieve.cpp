@@ -1,6 +1,6 @@
 ///
 /// @file   ParallelSieve.cpp
-/// @brief  Multi-threaded prime sieve using std::async.
+/// @brief  Multi-threaded prime sieve using a thread pool.
 ///
 /// Copyright (C) 2023 Kim Walisch, <kim.walisch@gmail.com>
 ///
@@ -8,20 +8,37 @@
 /// file in the top level directory.
 ///
 
+#include <primesieve/Checkpoint.hpp>
 #include <primesieve/config.hpp>
+#include <primesieve/CountPrintPrimes.hpp>
+#include <primesieve/CpuInfo.hpp>
+#include <primesieve/ForEachPrime.hpp>
 #include <primesieve/forward.hpp>
 #include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PrimePiLMO.hpp>
 #include <primesieve/PrimeSieve.hpp>
+#include <primesieve/PrintBuffer.hpp>
+#include <primesieve/SegmentSieve.hpp>
 #include <primesieve/macros.hpp>
 #include <primesieve/pmath.hpp>
+#include <primesieve/primesieve_error.hpp>
+#include <primesieve/StorePrimes.hpp>
+#include <primesieve/ThreadPool.hpp>
 #include <primesieve/Vector.hpp>
 
 #include <stdint.h>
 #include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <future>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
 
 using std::size_t;
 using namespace primesieve;
@@ -35,6 +52,219 @@ counts_t& operator+=(counts_t& v1, const counts_t& v2)
   return v1;
 }
 
+/// Rigorous upper bound for the number of primes inside
+/// [start, stop]. Unlike prime_count_upper() this is also
+/// valid for short intervals with many primes. For large
+/// intervals the bound is up to a few times larger than the
+/// number of primes, but the unused part of a slice is
+/// never written and hence usually never paged in.
+///
+size_t primeCountBound(uint64_t start, uint64_t stop)
+{
+  ASSERT(start <= stop);
+
+  // Only 2, 3, 5 and the numbers coprime
+  // to 30 can be prime.
+  uint64_t bound = ((stop - start) / 30 + 1) * 8 + 3;
+
+  // pi(x + y) - pi(x) < 2y / log(y) for x >= 1 and y > 1.
+  // H. L. Montgomery and R. C. Vaughan, "The large sieve",
+  // Mathematika 20 (1973), Theorem 2.
+  uint64_t y = stop - start + 1;
+  if (start >= 2 && y >= 2)
+  {
+    double mv = 2.0 * (double) y / std::log((double) y);
+    bound = std::min(bound, (uint64_t) mv + 1);
+  }
+
+  return (size_t) bound;
+}
+
+/// Store the primes inside [start, stop] in the primes
+/// array and return the number of primes stored.
+/// Throws an exception if there are more than
+/// maxSize primes.
+///
+template <typename T>
+size_t storeChunk(uint64_t start,
+                  uint64_t stop,
+                  T* primes,
+                  size_t maxSize)
+{
+  size_t n = 0;
+
+  for_each_prime_block(start, stop,
+    [&](const uint64_t* block, size_t size)
+    {
+      if_unlikely(size > maxSize - n)
+        throw primesieve_error("store_primes(): primes buffer slice is too small");
+      for (size_t i = 0; i < size; i++)
+        primes[n + i] = (T) block[i];
+      n += size;
+    });
+
+  return n;
+}
+
+/// The primes array has elements of typeSize bytes. Signed
+/// and unsigned integers of the same size share the same
+/// representation for the primes that fit into them.
+///
+size_t storeChunk(uint64_t start,
+                  uint64_t stop,
+                  void* primes,
+                  size_t maxSize,
+                  size_t typeSize)
+{
+  switch (typeSize)
+  {
+    case 2: return storeChunk(start, stop, (uint16_t*) primes, maxSize);
+    case 4: return storeChunk(start, stop, (uint32_t*) primes, maxSize);
+    case 8: return storeChunk(start, stop, (uint64_t*) primes, maxSize);
+  }
+
+  throw primesieve_error("store_primes(): unsupported integer type size " + std::to_string(typeSize));
+}
+
+/// The 8 bits of each byte of the sieve array correspond
+/// to the offsets { 7, 11, 13, 17, 19, 23, 29, 31 }.
+///
+const uint64_t bitOffsets[8] = { 7, 11, 13, 17, 19, 23, 29, 31 };
+
+/// Count the primes (countIndex = 0) or the prime k-tuplets
+/// (countIndex = 1 twins, 2 triplets, ...) inside [start, stop]
+/// of a segment's sieve array. The bits of the first and last
+/// byte that are outside [start, stop] are unset in a copy of
+/// the sieve array.
+///
+uint64_t countInterval(const uint8_t* sieve,
+                       size_t size,
+                       uint64_t low,
+                       uint64_t start,
+                       uint64_t stop,
+                       int countIndex,
+                       Vector<uint64_t>& buffer)
+{
+  uint64_t high = checkedAdd(low, size * 30 + 6);
+  start = std::max(start, low + 7);
+  stop = std::min(stop, high);
+
+  if (start > stop)
+    return 0;
+
+  size_t first = (size_t) ((start - low - 7) / 30);
+  size_t last = (size_t) ((stop - low - 7) / 30);
+  size_t bytes = last - first + 1;
+  size_t words = ceilDiv(bytes, 8);
+  buffer.resize(words);
+  buffer[words - 1] = 0;
+  std::memcpy(buffer.data(), &sieve[first], bytes);
+
+  auto* data = (uint8_t*) buffer.data();
+  uint64_t firstLow = low + first * 30;
+  uint64_t lastLow = low + last * 30;
+
+  for (int i = 0; i < 8; i++)
+  {
+    if (firstLow + bitOffsets[i] < start)
+      data[0] &= (uint8_t) ~(1 << i);
+    if (lastLow + bitOffsets[i] > stop)
+      data[bytes - 1] &= (uint8_t) ~(1 << i);
+  }
+
+  if (countIndex == 0)
+    return popcount(buffer.data(), words);
+
+  uint64_t counts[6] = { 0, 0, 0, 0, 0, 0 };
+  countAllkTuplets(buffer.data(), words, counts);
+  return counts[countIndex];
+}
+
+/// Each thread sieves its own range of adjacent chunks
+/// [first, last) in ascending order. Hence a thread can
+/// continue sieving its next chunk without re-initializing
+/// the sieving primes. Once a thread has finished its own
+/// range it steals the 2nd half of the largest remaining
+/// range of another thread.
+///
+class ChunkRanges
+{
+public:
+  /// The ith chunk is [chunkStops[i - 1] + 1, chunkStops[i]].
+  /// The ranges of the threads have about the same distance.
+  ///
+  ChunkRanges(int threads,
+              const Vector<uint64_t>& chunkStops,
+              uint64_t start)
+  {
+    ranges_.resize(threads);
+    uint64_t iters = chunkStops.size();
+    uint64_t dist = chunkStops[iters - 1] - start;
+    uint64_t i = 0;
+
+    for (int t = 0; t < threads; t++)
+    {
+      uint64_t stop = start + dist / threads * (t + 1);
+      ranges_[t].first = i;
+
+      while (i < iters &&
+             (chunkStops[i] <= stop || t == threads - 1))
+        i++;
+
+      ranges_[t].last = i;
+    }
+  }
+
+  /// Get the next chunk of the thread
+  bool next(int thread, uint64_t& i)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Range& range = ranges_[thread];
+
+    if (range.first >= range.last)
+    {
+      auto cmp = [](const Range& r1, const Range& r2) {
+        return r1.last - r1.first < r2.last - r2.first; };
+      Range& victim = *std::max_element(ranges_.begin(), ranges_.end(), cmp);
+      if (victim.first >= victim.last)
+        return false;
+
+      uint64_t mid = victim.first + (victim.last - victim.first) / 2;
+      range.first = mid;
+      range.last = victim.last;
+      victim.last = mid;
+    }
+
+    i = range.first++;
+    return true;
+  }
+
+  /// Get the next chunk of the thread if it is
+  /// adjacent to the thread's current chunk i.
+  bool nextAdjacent(int thread, uint64_t& i)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Range& range = ranges_[thread];
+
+    if (range.first >= range.last ||
+        range.first != i + 1)
+      return false;
+
+    i = range.first++;
+    return true;
+  }
+
+private:
+  struct Range
+  {
+    uint64_t first;
+    uint64_t last;
+  };
+
+  Vector<Range> ranges_;
+  std::mutex mutex_;
+};
+
 } // namespace
 
 namespace primesieve {
@@ -45,9 +275,21 @@ ParallelSieve::ParallelSieve()
   setNumThreads(threads);
 }
 
+/// std::thread::hardware_concurrency() returns the number
+/// of CPU cores of the host, even if the process may only
+/// use a few of them e.g. inside a container. Hence we
+/// also respect the process' affinity mask and the
+/// cgroup CPU quota (see CpuInfo::availableCpuCores()).
+///
 int ParallelSieve::getMaxThreads()
 {
   int maxThreads = std::thread::hardware_concurrency();
+  int cpuCores = (int) cpuInfo.availableCpuCores();
+
+  if (cpuCores > 0 &&
+      (maxThreads <= 0 || cpuCores < maxThreads))
+    maxThreads = cpuCores;
+
   return std::max(1, maxThreads);
 }
 
@@ -61,6 +303,16 @@ void ParallelSieve::setNumThreads(int threads)
   numThreads_ = inBetween(1, threads, getMaxThreads());
 }
 
+/// Save the finished chunks of sieve() to a checkpoint
+/// file (counting only). If the checkpoint has been
+/// loaded from a file, sieve() only sieves the chunks
+/// that have not yet been finished.
+///
+void ParallelSieve::setCheckpoint(Checkpoint* checkpoint)
+{
+  checkpoint_ = checkpoint;
+}
+
 /// Get an ideal number of threads for
 /// the start and stop numbers.
 ///
@@ -114,6 +366,116 @@ uint64_t ParallelSieve::align(uint64_t n) const
     return n32 - n % 30;
 }
 
+/// Get the start and stop numbers of the ith chunk
+/// of size threadDist. The chunks are disjoint and
+/// cover the interval [start_, stop_].
+///
+void ParallelSieve::getChunk(uint64_t i,
+                             uint64_t threadDist,
+                             uint64_t& start,
+                             uint64_t& stop) const
+{
+  start = start_ + threadDist * i;
+  stop = checkedAdd(start, threadDist);
+  stop = align(stop);
+
+  if (start > start_)
+    start = align(start) + 1;
+}
+
+/// Get the start and stop numbers of the ith of n shards
+/// (0 <= i < n). The shards are disjoint, they cover the
+/// interval [start_, stop_] and they are aligned like the
+/// chunks of the threads, hence prime k-tuplets are never
+/// split between two shards. If the ith shard is empty,
+/// then start > stop.
+///
+void ParallelSieve::getShard(uint64_t i,
+                             uint64_t n,
+                             uint64_t& start,
+                             uint64_t& stop) const
+{
+  if (i >= n)
+    throw primesieve_error("shard index must be < number of shards");
+
+  start = 1;
+  stop = 0;
+
+  if (start_ > stop_)
+    return;
+
+  uint64_t dist = getDistance();
+  uint64_t shardDist = dist / n + (dist % n != 0);
+  shardDist = checkedAdd(shardDist, 30 - shardDist % 30);
+
+  // The ith shard starts after align(start_ + shardDist * i)
+  if (i > 0 &&
+      (i > dist / shardDist ||
+       align(start_ + shardDist * i) >= stop_))
+    return;
+
+  getChunk(i, shardDist, start, stop);
+}
+
+/// Guided scheduling: the chunk size decreases towards the
+/// end of [start_, stop_] so that all threads finish at
+/// nearly the same time. Adjacent chunks of the same thread
+/// are sieved without re-initialization, hence the small
+/// chunks at the end add little overhead.
+/// @return  The stop numbers of the chunks, the ith chunk
+///          is [chunkStops[i - 1] + 1, chunkStops[i]].
+///
+Vector<uint64_t> ParallelSieve::getGuidedChunks(int threads) const
+{
+  ASSERT(threads > 0);
+  ASSERT(getDistance() > 0);
+
+  uint64_t maxDist = getThreadDistance(threads);
+  uint64_t minDist = maxDist / config::GUIDED_CHUNKS_MIN_FACTOR;
+  minDist = std::max(minDist, config::MIN_THREAD_DISTANCE);
+  uint64_t low = start_;
+  Vector<uint64_t> chunkStops;
+
+  while (true)
+  {
+    // Each thread sieves at least 2 of the remaining chunks
+    uint64_t dist = (stop_ - low) / (threads * 2);
+    dist = inBetween(minDist, dist, maxDist);
+    uint64_t stop = align(checkedAdd(low, dist));
+    chunkStops.push_back(stop);
+
+    if (stop >= stop_)
+      return chunkStops;
+
+    low = stop + 1;
+  }
+}
+
+/// When printing, the output of each chunk must be buffered
+/// in memory until all previous chunks have been printed.
+/// Hence we use much smaller chunks than for counting.
+///
+uint64_t ParallelSieve::getPrintDistance() const
+{
+  uint64_t dist = isqrt(stop_) * 4;
+  dist = std::max(dist, config::MIN_THREAD_DISTANCE);
+  dist += 30 - dist % 30;
+  return dist;
+}
+
+/// The chunk boundaries of a computation with a checkpoint
+/// file must not depend on the number of threads, as the
+/// computation may be resumed using a different number of
+/// threads (e.g. on another machine).
+///
+uint64_t ParallelSieve::getCheckpointDistance() const
+{
+  uint64_t dist = isqrt(stop_) * config::CHECKPOINT_CHUNK_FACTOR;
+  dist = std::max(dist, config::MIN_THREAD_DISTANCE);
+  dist += 30 - dist % 30;
+  return dist;
+}
+
 /// Print sieving status to stdout
 bool ParallelSieve::tryUpdateStatus(uint64_t dist)
 {
@@ -125,6 +487,40 @@ bool ParallelSieve::tryUpdateStatus(uint64_t dist)
   return lock.owns_lock();
 }
 
+const SievingPrimesTable* ParallelSieve::getSievingPrimesTable() const
+{
+  if (sievingPrimesTable_.empty())
+    return nullptr;
+  else
+    return &sievingPrimesTable_;
+}
+
+/// If the threads sieve more than 1 chunk each, then
+/// the sieving primes <= sqrt(stop) would be generated
+/// many times. In this case we generate the sieving
+/// primes only once (in parallel) and store them in a
+/// table that is shared by all threads.
+///
+void ParallelSieve::initSievingPrimesTable(int threads, uint64_t iters)
+{
+  if (iters > (uint64_t) threads &&
+      isSievingPrimesTableSmall(threads, getDistance()))
+    sievingPrimesTable_.init(isqrt(stop_), threads);
+  else
+    sievingPrimesTable_.clear();
+}
+
+/// The sieving primes table uses sqrt(stop) / 30 bytes of
+/// memory, up to 143 MiB near 2^64. If the table covers more
+/// numbers than each thread sieves, the threads generate
+/// their sieving primes themselves using little memory.
+///
+bool ParallelSieve::isSievingPrimesTableSmall(int threads, uint64_t dist) const
+{
+  ASSERT(threads > 0);
+  return isqrt(stop_) <= dist / threads;
+}
+
 /// Sieve the primes and prime k-tuplets in [start, stop]
 /// in parallel using multi-threading.
 ///
@@ -135,22 +531,73 @@ void ParallelSieve::sieve()
   if (start_ > stop_)
     return;
 
+  // Check before any thread has printed primes
+  if (isFlag(PRINT_UINT32) &&
+      stop_ > 0xffffffffull)
+    throw primesieve_error("cannot print primes > 2^32 - 1 as uint32");
+
   int threads = idealNumThreads();
 
-  if (threads == 1)
+  // Counting the primes of a large interval using
+  // pi(stop) - pi(start - 1) is much faster than sieving.
+  if ((getFlags() & ~PRINT_STATUS) == COUNT_PRIMES &&
+      !checkpoint_ &&
+      isPrimePiLMOUseful(start_, stop_))
+  {
+    setStatus(0);
+    auto t1 = std::chrono::system_clock::now();
+    counts_[0] = primePiLMO(stop_, threads);
+    if (start_ > 0)
+      counts_[0] -= primePiLMO(start_ - 1, threads);
+    auto t2 = std::chrono::system_clock::now();
+    std::chrono::duration<double> seconds = t2 - t1;
+    seconds_ = seconds.count();
+    setStatus(100);
+  }
+  else if (checkpoint_ && !isPrint())
+  {
+    setStatus(0);
+    auto t1 = std::chrono::system_clock::now();
+    sieveCheckpoint(threads);
+    auto t2 = std::chrono::system_clock::now();
+    std::chrono::duration<double> seconds = t2 - t1;
+    seconds_ = seconds.count();
+    setStatus(100);
+  }
+  else if (threads == 1)
     PrimeSieve::sieve();
+  else if (isPrint())
+  {
+    setStatus(0);
+    auto t1 = std::chrono::system_clock::now();
+    printParallel(threads);
+    auto t2 = std::chrono::system_clock::now();
+    std::chrono::duration<double> seconds = t2 - t1;
+    seconds_ = seconds.count();
+    setStatus(100);
+  }
   else
   {
     setStatus(0);
     auto t1 = std::chrono::system_clock::now();
     uint64_t dist = getDistance();
-    uint64_t threadDist = getThreadDistance(threads);
-    uint64_t iters = ((dist - 1) / threadDist) + 1;
+    Vector<uint64_t> chunkStops = getGuidedChunks(threads);
+    uint64_t iters = chunkStops.size();
     threads = inBetween(1, threads, iters);
-    std::atomic<uint64_t> a(0);
+    initSievingPrimesTable(threads, iters);
+    ChunkRanges chunkRanges(threads, chunkStops, start_);
+
+    // Get the start and stop numbers of the ith chunk
+    auto getChunk = [&](uint64_t i, uint64_t& start, uint64_t& stop)
+    {
+      start = (i > 0) ? chunkStops[i - 1] + 1 : start_;
+      stop = chunkStops[i];
+    };
+
+    Vector<counts_t> threadCounts(threads);
 
     // Each thread executes 1 task
-    auto task = [&]()
+    auto task = [&](int thread)
     {
       PrimeSieve ps(this);
 
@@ -167,31 +614,38 @@ void ParallelSieve::sieve()
       counts_t counts;
       counts.fill(0);
 
-      while ((i = a.fetch_add(1, std::memory_order_relaxed)) < iters)
+      // Called by CountPrintPrimes before sieving
+      // the last segment of the current chunk.
+      std::function<bool(uint64_t&)> nextChunk = [&](uint64_t& stop)
       {
-        uint64_t start = start_ + threadDist * i;
-        uint64_t stop = checkedAdd(start, threadDist);
-        stop = align(stop);
+        if (!chunkRanges.nextAdjacent(thread, i))
+          return false;
+
+        uint64_t start;
+        getChunk(i, start, stop);
+        return true;
+      };
+
+      ps.setNextChunk(&nextChunk);
 
-        if (start > start_)
-          start = align(start) + 1;
+      while (chunkRanges.next(thread, i))
+      {
+        uint64_t start;
+        uint64_t stop;
+        getChunk(i, start, stop);
 
         // Sieve the primes inside [start, stop]
         ps.sieve(start, stop);
         counts += ps.getCounts();
       }
 
-      return counts;
+      threadCounts[thread] = counts;
     };
 
-    Vector<std::future<counts_t>> futures;
-    futures.reserve(threads);
-
-    for (int t = 0; t < threads; t++)
-      futures.emplace_back(std::async(std::launch::async, task));
+    ThreadPool::get().run(threads, task);
 
-    for (auto& f : futures)
-      counts_ += f.get();
+    for (auto& counts : threadCounts)
+      counts_ += counts;
 
     auto t2 = std::chrono::system_clock::now();
     std::chrono::duration<double> seconds = t2 - t1;
@@ -200,4 +654,647 @@ void ParallelSieve::sieve()
   }
 }
 
+/// Count the primes and prime k-tuplets in [start, stop]
+/// using chunks of size getCheckpointDistance(). Each chunk
+/// is sieved separately and its counts are added to the
+/// checkpoint, which periodically saves the finished chunks
+/// to a file. Chunks that have already been finished
+/// (by a previous run) are skipped.
+///
+void ParallelSieve::sieveCheckpoint(int threads)
+{
+  uint64_t dist = getDistance();
+  uint64_t chunkDist = getCheckpointDistance();
+  uint64_t chunks = (dist > 0) ? ((dist - 1) / chunkDist) + 1 : 1;
+  int flags = getFlags() & (COUNT_SEXTUPLETS * 2 - 1);
+
+  checkpoint_->init(start_, stop_, flags, chunkDist, chunks);
+  checkpoint_->save();
+  uint64_t finished = checkpoint_->getFinishedChunks();
+  uint64_t pending = chunks - finished;
+  updateStatus(std::min(dist, finished * chunkDist));
+
+  if (pending > 0)
+  {
+    threads = inBetween(1, threads, pending);
+    initSievingPrimesTable(threads, pending);
+
+    auto task = [&](int)
+    {
+      PrimeSieve ps(this);
+      PreSieve& preSieve = ps.getPreSieve();
+      preSieve.init(0, dist / threads);
+      uint64_t i;
+
+      while (checkpoint_->nextChunk(i))
+      {
+        uint64_t start;
+        uint64_t stop;
+        getChunk(i, chunkDist, start, stop);
+        ps.sieve(start, stop);
+        checkpoint_->finishChunk(i, ps.getCounts());
+      }
+    };
+
+    ThreadPool::get().run(threads, task);
+  }
+
+  checkpoint_->save();
+  counts_ = checkpoint_->getCounts();
+}
+
+/// Returns the size of the primes buffer required by
+/// storePrimes() or 0 if the interval [start_, stop_]
+/// is too small for multi-threading.
+///
+size_t ParallelSieve::storePrimesSize() const
+{
+  if (start_ > stop_)
+    return 0;
+
+  int threads = idealNumThreads();
+  if (threads == 1)
+    return 0;
+
+  uint64_t dist = getDistance();
+  uint64_t threadDist = getThreadDistance(threads);
+  uint64_t iters = ((dist - 1) / threadDist) + 1;
+  size_t size = 0;
+
+  for (uint64_t i = 0; i < iters; i++)
+  {
+    uint64_t start;
+    uint64_t stop;
+    getChunk(i, threadDist, start, stop);
+    size += primeCountBound(start, stop);
+  }
+
+  return size;
+}
+
+/// Generate the primes inside [start_, stop_] in parallel.
+/// Each chunk of the interval is assigned a slice of the
+/// primes buffer whose size is a rigorous upper bound for
+/// the number of primes inside the chunk. Hence the threads can store
+/// their primes without any synchronization. At the end we
+/// remove the gaps between the slices.
+/// @return  The number of primes stored in the primes buffer.
+///
+size_t ParallelSieve::storePrimes(void* primes,
+                                  size_t size,
+                                  size_t typeSize)
+{
+  ASSERT(storePrimesSize() > 0);
+
+  int threads = idealNumThreads();
+  uint64_t dist = getDistance();
+  uint64_t threadDist = getThreadDistance(threads);
+  uint64_t iters = ((dist - 1) / threadDist) + 1;
+  threads = inBetween(1, threads, iters);
+
+  Vector<size_t> offsets(iters + 1);
+  Vector<size_t> counts(iters);
+  offsets[0] = 0;
+
+  for (uint64_t i = 0; i < iters; i++)
+  {
+    uint64_t start;
+    uint64_t stop;
+    getChunk(i, threadDist, start, stop);
+    offsets[i + 1] = offsets[i] + primeCountBound(start, stop);
+  }
+
+  if (offsets[iters] > size)
+    throw primesieve_error("store_primes(): primes buffer is too small");
+
+  char* bytes = (char*) primes;
+  std::atomic<uint64_t> a(0);
+
+  auto task = [&](int)
+  {
+    uint64_t i;
+
+    while ((i = a.fetch_add(1, std::memory_order_relaxed)) < iters)
+    {
+      uint64_t start;
+      uint64_t stop;
+      getChunk(i, threadDist, start, stop);
+      void* slice = bytes + offsets[i] * typeSize;
+      size_t maxSize = offsets[i + 1] - offsets[i];
+      counts[i] = storeChunk(start, stop, slice, maxSize, typeSize);
+    }
+  };
+
+  ThreadPool::get().run(threads, task);
+
+  // Compact the slices, the slices are
+  // moved towards the start of the buffer.
+  size_t count = counts[0];
+
+  for (uint64_t i = 1; i < iters; i++)
+  {
+    std::memmove(bytes + count * typeSize,
+                 bytes + offsets[i] * typeSize,
+                 counts[i] * typeSize);
+    count += counts[i];
+  }
+
+  return count;
+}
+
+/// Calls callback(primes, size, thread) for each block of
+/// primes inside [start_, stop_]. Each thread processes
+/// many disjoint chunks in ascending order.
+///
+void ParallelSieve::forEachPrimeBlock(const std::function<void(const uint64_t*, size_t, int)>& callback)
+{
+  if (start_ > stop_)
+    return;
+
+  int threads = idealNumThreads();
+
+  if (threads == 1)
+  {
+    for_each_prime_block(start_, stop_,
+      [&](const uint64_t* primes, size_t size)
+      {
+        callback(primes, size, 0);
+      });
+
+    return;
+  }
+
+  uint64_t dist = getDistance();
+  uint64_t threadDist = getThreadDistance(threads);
+  uint64_t iters = ((dist - 1) / threadDist) + 1;
+  threads = inBetween(1, threads, iters);
+  std::atomic<uint64_t> a(0);
+
+  auto task = [&](int thread)
+  {
+    uint64_t i;
+
+    while ((i = a.fetch_add(1, std::memory_order_relaxed)) < iters)
+    {
+      uint64_t start;
+      uint64_t stop;
+      getChunk(i, threadDist, start, stop);
+
+      for_each_prime_block(start, stop,
+        [&](const uint64_t* primes, size_t size)
+        {
+          callback(primes, size, thread);
+        });
+    }
+  };
+
+  ThreadPool::get().run(threads, task);
+}
+
+/// Calls callback(sieve, size, low, thread) for each segment
+/// inside [start_, stop_]. Each thread sieves many disjoint
+/// chunks. Adjacent chunks may share the same boundary byte,
+/// but its bits are only set in one of the two segments.
+///
+void ParallelSieve::forEachSegment(const std::function<void(const uint8_t*, size_t, uint64_t, int)>& callback)
+{
+  if (start_ > stop_ ||
+      stop_ < 7)
+    return;
+
+  int threads = idealNumThreads();
+
+  if (threads == 1)
+  {
+    PrimeSieve ps(this);
+    ps.setStart(start_);
+    ps.setStop(stop_);
+    SegmentSieve segmentSieve(ps);
+    segmentSieve.sieve([&](const uint8_t* sieve, size_t size, uint64_t low)
+    {
+      callback(sieve, size, low, 0);
+    });
+
+    return;
+  }
+
+  uint64_t dist = getDistance();
+  uint64_t threadDist = getThreadDistance(threads);
+  uint64_t iters = ((dist - 1) / threadDist) + 1;
+  threads = inBetween(1, threads, iters);
+  initSievingPrimesTable(threads, iters);
+  std::atomic<uint64_t> a(0);
+
+  auto task = [&](int thread)
+  {
+    PrimeSieve ps(this);
+    PreSieve& preSieve = ps.getPreSieve();
+    preSieve.init(0, dist / threads);
+
+    SegmentCallback segmentCallback =
+      [&](const uint8_t* sieve, size_t size, uint64_t low)
+      {
+        callback(sieve, size, low, thread);
+      };
+
+    uint64_t i;
+
+    while ((i = a.fetch_add(1, std::memory_order_relaxed)) < iters)
+    {
+      uint64_t start;
+      uint64_t stop;
+      getChunk(i, threadDist, start, stop);
+
+      if (stop >= 7)
+      {
+        ps.setStart(start);
+        ps.setStop(stop);
+        SegmentSieve segmentSieve(ps);
+        segmentSieve.sieve(segmentCallback);
+      }
+    }
+  };
+
+  ThreadPool::get().run(threads, task);
+}
+
+/// Print primes (or prime k-tuplets) in parallel. Each thread
+/// sieves a chunk and prints its primes into a buffer. The
+/// buffers are then printed in order. In order to bound the
+/// memory usage at most 2 * threads chunks may be in flight,
+/// a thread must wait before sieving chunk i until chunk
+/// i - window has been printed. Printing to stdout is done
+/// by whichever thread completes the next chunk in order.
+///
+void ParallelSieve::printParallel(int threads)
+{
+  uint64_t dist = getDistance();
+  uint64_t threadDist = getPrintDistance();
+  uint64_t iters = ((dist - 1) / threadDist) + 1;
+  threads = inBetween(1, threads, iters);
+  initSievingPrimesTable(threads, iters);
+  uint64_t window = threads * 2;
+  bool isVarint = isFlag(PRINT_VARINT);
+  bool isBitmap = isFlag(PRINT_BITMAP);
+
+  struct Chunk
+  {
+    Vector<char> output;
+    uint64_t first = 0;
+    uint64_t last = 0;
+    bool isReady = false;
+  };
+
+  Vector<Chunk> chunks(window);
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::atomic<uint64_t> a(0);
+  uint64_t next = 0;
+  uint64_t prevPrime = 0;
+  bool isPrinting = false;
+  bool isError = false;
+
+  // Print the chunks that are ready, in order
+  auto printChunks = [&](std::unique_lock<std::mutex>& lock)
+  {
+    Vector<char> output;
+
+    while (!isPrinting &&
+           chunks[next % window].isReady)
+    {
+      Chunk& chunk = chunks[next % window];
+      output.swap(chunk.output);
+      uint64_t first = chunk.first;
+      uint64_t last = chunk.last;
+      chunk.isReady = false;
+      isPrinting = true;
+      lock.unlock();
+
+      const char* bytes = output.data();
+      const char* end = bytes + output.size();
+
+      if (next > 0 && bytes < end)
+      {
+        // The varint format stores the difference to the
+        // previous prime, but the chunk's first prime has
+        // been encoded as the difference to 0.
+        if (isVarint)
+        {
+          char tmp[10];
+          uint64_t n;
+          bytes = PrintBuffer::decodeVarint(bytes, &n);
+          std::size_t size = PrintBuffer::encodeVarint(first - prevPrime, tmp);
+          std::fwrite(tmp, 1, size, stdout);
+        }
+        // The first byte of the chunk's sieve array
+        // is the same as the last byte of the
+        // previous chunk (with all bits unset).
+        if (isBitmap)
+          bytes++;
+      }
+
+      if (bytes < end)
+        std::fwrite(bytes, 1, end - bytes, stdout);
+      if (isVarint && !output.empty())
+        prevPrime = last;
+
+      output.clear();
+      lock.lock();
+      isPrinting = false;
+      next++;
+      cond.notify_all();
+    }
+  };
+
+  Vector<counts_t> threadCounts(threads);
+
+  auto task = [&](int thread)
+  {
+    PrimeSieve ps(this);
+    PreSieve& preSieve = ps.getPreSieve();
+    preSieve.init(0, dist / threads);
+
+    Vector<char> output;
+    ps.setPrintOutput(&output);
+
+    uint64_t i;
+    counts_t counts;
+    counts.fill(0);
+
+    try
+    {
+      while ((i = a.fetch_add(1, std::memory_order_relaxed)) < iters)
+      {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          cond.wait(lock, [&] { return i < next + window || isError; });
+          if (isError)
+            break;
+        }
+
+        uint64_t start;
+        uint64_t stop;
+        getChunk(i, threadDist, start, stop);
+
+        ps.sieve(start, stop);
+        counts += ps.getCounts();
+
+        // Get the first and last prime of the
+        // chunk from the varint encoded output.
+        uint64_t first = 0;
+        uint64_t last = 0;
+
+        if (isVarint && !output.empty())
+        {
+          const char* bytes = output.data();
+          const char* end = bytes + output.size();
+          uint64_t n;
+          bytes = PrintBuffer::decodeVarint(bytes, &first);
+          for (last = first; bytes < end; last += n)
+            bytes = PrintBuffer::decodeVarint(bytes, &n);
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        Chunk& chunk = chunks[i % window];
+        chunk.output.swap(output);
+        chunk.first = first;
+        chunk.last = last;
+        chunk.isReady = true;
+        output.clear();
+        printChunks(lock);
+      }
+    }
+    catch (...)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      isError = true;
+      cond.notify_all();
+      throw;
+    }
+
+    threadCounts[thread] = counts;
+  };
+
+  ThreadPool::get().run(threads, task);
+
+  for (auto& counts : threadCounts)
+    counts_ += counts;
+}
+
+/// Count the primes (countIndex = 0) or the prime k-tuplets
+/// (countIndex = 1 twins, 2 triplets, ...) inside each of the
+/// intervals [intervals[i].first, intervals[i].second] and
+/// store the result in counts[i]. The intervals are sorted by
+/// their start number and intervals that overlap or that are
+/// close to each other are merged into groups. Each group is
+/// sieved only once and the groups are sieved in parallel.
+/// All threads share the same sieving primes table, hence
+/// the sieving primes are generated only once.
+///
+void ParallelSieve::countBatch(const std::pair<uint64_t, uint64_t>* intervals,
+                               size_t size,
+                               int countIndex,
+                               uint64_t* counts)
+{
+  struct Interval
+  {
+    uint64_t start;
+    uint64_t stop;
+    size_t index;
+  };
+
+  // The intervals [first, last) of sorted
+  struct Group
+  {
+    uint64_t start;
+    uint64_t stop;
+    size_t first;
+    size_t last;
+  };
+
+  Vector<Interval> sorted;
+  sorted.reserve(size);
+
+  for (size_t i = 0; i < size; i++)
+  {
+    uint64_t start = intervals[i].first;
+    uint64_t stop = intervals[i].second;
+    counts[i] = 0;
+
+    // The primes and prime k-tuplets < 33 are counted using
+    // PrimeSieve. Since 32 % 30 = 2 no prime k-tuplet
+    // crosses the number 32.
+    if (start <= 32 && start <= stop)
+    {
+      PrimeSieve ps;
+      ps.sieve(start, std::min<uint64_t>(stop, 32), COUNT_PRIMES << countIndex);
+      counts[i] = ps.getCount(countIndex);
+      start = 33;
+    }
+
+    if (start <= stop)
+      sorted.push_back({ start, stop, i });
+  }
+
+  if (sorted.empty())
+    return;
+
+  std::sort(sorted.begin(), sorted.end(),
+    [](const Interval& a, const Interval& b) {
+      return a.start < b.start; });
+
+  // Sieving the gap between two intervals is cheaper than
+  // initializing the sieving primes for a new group if the
+  // gap is smaller than sqrt(stop) / BATCH_MERGE_DIVISOR.
+  Vector<Group> groups;
+  uint64_t totalDist = 0;
+
+  for (size_t i = 0; i < sorted.size(); i++)
+  {
+    const Interval& iv = sorted[i];
+
+    if (!groups.empty())
+    {
+      Group& group = groups.back();
+      uint64_t stop = std::max(group.stop, iv.stop);
+      uint64_t maxGap = isqrt(stop) / config::BATCH_MERGE_DIVISOR;
+
+      if (iv.start <= group.stop ||
+          iv.start - group.stop <= maxGap)
+      {
+        group.stop = stop;
+        group.last = i + 1;
+        continue;
+      }
+    }
+
+    groups.push_back({ iv.start, iv.stop, i, i + 1 });
+  }
+
+  for (auto& group : groups)
+    totalDist = checkedAdd(totalDist, checkedAdd(group.stop - group.start, isqrt(group.stop)));
+
+  start_ = groups.front().start;
+  stop_ = 0;
+  for (auto& group : groups)
+    stop_ = std::max(stop_, group.stop);
+
+  uint64_t threads = totalDist / config::MIN_THREAD_DISTANCE;
+  threads = inBetween(1, threads, numThreads_);
+  threads = inBetween(1, threads, groups.size());
+
+  // All groups share the sieving primes <= sqrt(max(stop))
+  if (groups.size() > 1 &&
+      isSievingPrimesTableSmall((int) threads, totalDist))
+    sievingPrimesTable_.init(isqrt(stop_), (int) threads);
+  else
+    sievingPrimesTable_.clear();
+
+  std::atomic<size_t> next(0);
+
+  auto task = [&](int)
+  {
+    PrimeSieve ps(this);
+    PreSieve& preSieve = ps.getPreSieve();
+    preSieve.init(0, totalDist / threads);
+    Vector<uint64_t> buffer;
+    Vector<size_t> active;
+    size_t g;
+
+    while ((g = next.fetch_add(1, std::memory_order_relaxed)) < groups.size())
+    {
+      const Group& group = groups[g];
+      size_t i = group.first;
+      active.clear();
+      ps.setStart(group.start);
+      ps.setStop(group.stop);
+      SegmentSieve segmentSieve(ps);
+
+      segmentSieve.sieve([&](const uint8_t* sieve, size_t bytes, uint64_t low)
+      {
+        uint64_t high = checkedAdd(low, bytes * 30 + 6);
+
+        for (; i < group.last && sorted[i].start <= high; i++)
+          active.push_back(i);
+
+        size_t n = 0;
+
+        // Each interval belongs to a single group, hence
+        // the threads never write to the same counts[j].
+        for (size_t j : active)
+        {
+          const Interval& iv = sorted[j];
+          counts[iv.index] += countInterval(sieve, bytes, low, iv.start, iv.stop, countIndex, buffer);
+          if (iv.stop > high)
+            active[n++] = j;
+        }
+
+        active.resize(n);
+      });
+    }
+  };
+
+  ThreadPool::get().run((int) threads, task);
+}
+
+/// Count the primes inside [start_, stops[i]] for each i using
+/// a single parallel pass over [start_, stop_]. The stops must
+/// be sorted in ascending order and be <= stop_. The ith stop
+/// partitions the interval into (stops[i - 1], stops[i]], the
+/// primes of each part are counted per segment and the counts
+/// of the threads are summed up afterwards.
+///
+void ParallelSieve::countPrefixes(const uint64_t* stops,
+                                  size_t size,
+                                  uint64_t* counts)
+{
+  ASSERT(std::is_sorted(stops, stops + size));
+  std::fill_n(counts, size, 0);
+
+  if (size == 0 ||
+      start_ > stop_)
+    return;
+
+  // forEachSegment() uses the same number of threads
+  int threads = idealNumThreads();
+  Vector<Vector<uint64_t>> threadCounts(threads);
+  Vector<Vector<uint64_t>> buffers(threads);
+
+  for (auto& threadCount : threadCounts)
+  {
+    threadCount.resize(size);
+    std::fill(threadCount.begin(), threadCount.end(), 0);
+  }
+
+  forEachSegment([&](const uint8_t* sieve, size_t bytes, uint64_t low, int thread)
+  {
+    Vector<uint64_t>& threadCount = threadCounts[thread];
+    uint64_t high = checkedAdd(low, bytes * 30 + 6);
+    size_t i = std::lower_bound(stops, stops + size, low) - stops;
+
+    for (; i < size; i++)
+    {
+      uint64_t start = (i > 0) ? stops[i - 1] + 1 : start_;
+      if (start > high)
+        break;
+      threadCount[i] += countInterval(sieve, bytes, low, start, stops[i], 0, buffers[thread]);
+    }
+  });
+
+  // The sieve array does not contain 2, 3 and 5
+  for (uint64_t prime : { 2, 3, 5 })
+  {
+    size_t i = std::lower_bound(stops, stops + size, prime) - stops;
+    if (prime >= start_ && i < size)
+      counts[i]++;
+  }
+
+  for (auto& threadCount : threadCounts)
+    for (size_t i = 0; i < size; i++)
+      counts[i] += threadCount[i];
+
+  for (size_t i = 1; i < size; i++)
+    counts[i] += counts[i - 1];
+}
+
 } // namespace
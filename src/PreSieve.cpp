@@ -356,17 +356,23 @@ void PreSieve::initBuffers()
     for (uint64_t prime : bufferPrimes[i])
       eratSmall.addSievingPrime(prime, start);
 
-    eratSmall.crossOff(buffers_[i]);
+    eratSmall.crossOff(buffers_[i].data(), buffers_[i].size());
   }
 }
 
-void PreSieve::preSieve(Vector<uint8_t>& sieve,
+/// Pre-sieve the sieve array (or an L1 cache sized block
+/// of the sieve array) whose first byte corresponds
+/// to the numbers [segmentLow, segmentLow + 30[.
+/// @pre The sieve array must have a capacity >= 4 bytes.
+///
+void PreSieve::preSieve(uint8_t* sieve,
+                        std::size_t sieveSize,
                         uint64_t segmentLow) const
 {
   if (buffers_[0].empty())
-    preSieveSmall(sieve, segmentLow);
+    preSieveSmall(sieve, sieveSize, segmentLow);
   else
-    preSieveLarge(sieve, segmentLow);
+    preSieveLarge(sieve, sieveSize, segmentLow);
 
   // Pre-sieving removes the primes < 100. We
   // have to undo that work and reset these bits
@@ -374,17 +380,16 @@ void PreSieve::preSieve(Vector<uint8_t>& sieve,
   if (segmentLow < 120)
   {
     uint64_t i = segmentLow / 30;
-    uint8_t* sieveArray = sieve.data();
     Array<uint8_t, 8> primeBits = { 0xff, 0xef, 0x77, 0x3f, 0xdb, 0xed, 0x9e, 0xfc };
 
-    ASSERT(sieve.capacity() >= 4);
     for (std::size_t j = 0; j < 4; j++)
-      sieveArray[j] = primeBits[i + j];
+      sieve[j] = primeBits[i + j];
   }
 }
 
 /// Pre-sieve with the primes <= 13
-void PreSieve::preSieveSmall(Vector<uint8_t>& sieve,
+void PreSieve::preSieveSmall(uint8_t* sieve,
+                             std::size_t sieveSize,
                              uint64_t segmentLow)
 {
   uint64_t size = buffer_7_11_13.size();
@@ -393,25 +398,26 @@ void PreSieve::preSieveSmall(Vector<uint8_t>& sieve,
   uint64_t sizeLeft = size - i;
   auto buffer = buffer_7_11_13.data();
 
-  if (sieve.size() <= sizeLeft)
-    copy_n(&buffer[i], sieve.size(), sieve.begin());
+  if (sieveSize <= sizeLeft)
+    copy_n(&buffer[i], sieveSize, sieve);
   else
   {
     // Copy the last remaining bytes of buffer
     // to the beginning of the sieve array
-    copy_n(&buffer[i], sizeLeft, sieve.begin());
+    copy_n(&buffer[i], sizeLeft, sieve);
 
     // Restart copying at the beginning of buffer
-    for (i = sizeLeft; i + size < sieve.size(); i += size)
+    for (i = sizeLeft; i + size < sieveSize; i += size)
       copy_n(buffer, size, &sieve[i]);
 
     // Copy the last remaining bytes
-    copy_n(buffer, sieve.size() - i, &sieve[i]);
+    copy_n(buffer, sieveSize - i, &sieve[i]);
   }
 }
 
 /// Pre-sieve with the primes < 100
-void PreSieve::preSieveLarge(Vector<uint8_t>& sieve,
+void PreSieve::preSieveLarge(uint8_t* sieve,
+                             std::size_t sieveSize,
                              uint64_t segmentLow) const
 {
   uint64_t offset = 0;
@@ -420,8 +426,8 @@ void PreSieve::preSieveLarge(Vector<uint8_t>& sieve,
   for (std::size_t i = 0; i < buffers_.size(); i++)
     pos[i] = (segmentLow % (buffers_[i].size() * 30)) / 30;
 
-  while (offset < sieve.size()) {
-    uint64_t bytesToCopy = sieve.size() - offset;
+  while (offset < sieveSize) {
+    uint64_t bytesToCopy = sieveSize - offset;
 
     for (std::size_t i = 0; i < buffers_.size(); i++) {
       uint64_t left = buffers_[i].size() - pos[i];
@@ -0,0 +1,182 @@
+///
+/// @file   PrefetchThread.cpp
+/// @brief  primesieve::iterator::next_prime() stalls whenever its
+///         primes buffer is empty and the next segment needs to be
+///         sieved. In prefetch mode this work is done by a
+///         background thread: while the user iterates over the
+///         primes of the current buffer, the background thread
+///         generates the primes of the next buffer. Both threads
+///         then swap their buffers (double buffering).
+///
+///         The background thread owns the PrimeGenerator (and hence
+///         the Erat & SievingPrimes state) of the iterator until the
+///         PrefetchThread is destroyed. Afterwards the iterator can
+///         continue using its PrimeGenerator in the main thread.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/PrefetchThread.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/IteratorHelper.hpp>
+#include <primesieve/PrimeGenerator.hpp>
+#include <primesieve/macros.hpp>
+#include <primesieve/Vector.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace primesieve {
+
+PrefetchThread::PrefetchThread(IteratorData& iterData,
+                               uint64_t start,
+                               uint64_t stopHint) :
+  start_(start),
+  stopHint_(stopHint),
+  iterData_(iterData),
+  thread_(&PrefetchThread::run, this)
+{ }
+
+/// Waits until the background thread has finished
+/// its current work and then stops the thread.
+///
+PrefetchThread::~PrefetchThread()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    isExit_ = true;
+  }
+
+  cond_.notify_all();
+  thread_.join();
+}
+
+/// Returns the start number of the current PrimeGenerator.
+/// Must be used when switching back to the main thread.
+///
+uint64_t PrefetchThread::getStart()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  wait(lock);
+  return start_;
+}
+
+/// Swap the user's primes buffer with the primes buffer of the
+/// background thread. If prefetchNext = true we immediately
+/// request the next primes.
+///
+void PrefetchThread::fillNextPrimes(Vector<uint64_t>& primes,
+                                    std::size_t* size,
+                                    bool prefetchNext)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  if (!isRequest_ && !isReady_)
+  {
+    isRequest_ = true;
+    cond_.notify_all();
+  }
+
+  cond_.wait(lock, [&] { return isReady_; });
+  isReady_ = false;
+
+  if_unlikely(error_)
+  {
+    std::exception_ptr error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+
+  primes.swap(primes_);
+  *size = size_;
+  size_ = 0;
+
+  if (prefetchNext)
+  {
+    isRequest_ = true;
+    cond_.notify_all();
+  }
+}
+
+/// Wait until the background thread is idle
+void PrefetchThread::wait(std::unique_lock<std::mutex>& lock)
+{
+  cond_.wait(lock, [&] { return !isRequest_; });
+}
+
+void PrefetchThread::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true)
+  {
+    cond_.wait(lock, [&] { return isRequest_ || isExit_; });
+
+    if (isExit_)
+      return;
+
+    lock.unlock();
+
+    try
+    {
+      sieve();
+    }
+    catch (...)
+    {
+      lock.lock();
+      error_ = std::current_exception();
+      lock.unlock();
+    }
+
+    lock.lock();
+    isRequest_ = false;
+    isReady_ = true;
+    cond_.notify_all();
+  }
+}
+
+/// Same algorithm as iterator::generate_next_primes(),
+/// but runs in the background thread.
+///
+void PrefetchThread::sieve()
+{
+  // fillNextPrimes() requires that the primes buffer
+  // has been sized by PrimeGenerator::initNextPrimes().
+  // As we swap the buffers we need to make sure
+  // both buffers are sufficiently large.
+  std::size_t minSize = std::max<std::size_t>(config::PREFETCH_PRIMES, iterData_.batchSize);
+  if (primes_.size() < minSize)
+  {
+    primes_.clear();
+    primes_.resize(minSize);
+  }
+
+  while (true)
+  {
+    if (!iterData_.primeGenerator)
+    {
+      IteratorHelper::updateNext(start_, stopHint_, iterData_);
+      iterData_.newPrimeGenerator(start_, iterData_.stop, iterData_.preSieve);
+    }
+
+    iterData_.primeGenerator->fillNextPrimes(primes_, &size_);
+
+    // The primes buffer is empty because the next prime > stop.
+    // In this case we reset the primeGenerator object, increase
+    // the start & stop numbers and sieve the next segment.
+    if_unlikely(size_ == 0)
+      iterData_.deletePrimeGenerator();
+    else
+      return;
+  }
+}
+
+} // namespace
@@ -18,6 +18,7 @@
 /// file in the top level directory.
 ///
 
+#include <primesieve/config.hpp>
 #include <primesieve/Erat.hpp>
 #include <primesieve/forward.hpp>
 #include <primesieve/littleendian_cast.hpp>
@@ -119,10 +120,14 @@ namespace primesieve {
 
 PrimeGenerator::PrimeGenerator(uint64_t start,
                                uint64_t stop,
-                               PreSieve& preSieve) :
+                               PreSieve& preSieve,
+                               std::size_t maxNextPrimes) :
   Erat(start, stop),
+  maxNextPrimes_(maxNextPrimes),
   preSieve_(preSieve)
-{ }
+{
+  ASSERT(maxNextPrimes_ >= config::MIN_ITERATOR_PRIMES);
+}
 
 uint64_t PrimeGenerator::maxCachedPrime()
 {
@@ -219,9 +224,9 @@ void PrimeGenerator::initNextPrimes(Vector<uint64_t>& primes,
     }
   };
 
-  // A buffer of 1024 primes provides good
-  // performance with little memory usage.
-  std::size_t maxSize = 1 << 10;
+  // The batch size of primesieve::iterator,
+  // ITERATOR_PRIMES (1024) by default.
+  std::size_t maxSize = maxNextPrimes_;
 
   if (start_ <= maxCachedPrime())
   {
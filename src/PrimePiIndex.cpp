@@ -0,0 +1,251 @@
+///
+/// @file   PrimePiIndex.cpp
+/// @brief  On-disk index of the prime counts pi(i * stride).
+///         Counting the primes inside a huge interval using
+///         the index only requires sieving the two partial
+///         blocks at the ends of the interval.
+///
+///         File format (all integers are 64-bit little-endian):
+///         "PRIMEPI1", stride, size, pi(0), pi(stride), ...
+///         pi((size - 1) * stride).
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/PrimePiIndex.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PrimeSieve.hpp>
+#include <primesieve/primesieve_error.hpp>
+#include <primesieve/Vector.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+namespace {
+
+const char magic[8] = { 'P', 'R', 'I', 'M', 'E', 'P', 'I', '1' };
+
+void writeUint64(std::FILE* file, uint64_t n)
+{
+  unsigned char bytes[8];
+  for (int i = 0; i < 8; i++)
+    bytes[i] = (unsigned char) (n >> (i * 8));
+  std::fwrite(bytes, 1, 8, file);
+}
+
+bool readUint64(std::FILE* file, uint64_t& n)
+{
+  unsigned char bytes[8];
+  if (std::fread(bytes, 1, 8, file) != 8)
+    return false;
+
+  n = 0;
+  for (int i = 0; i < 8; i++)
+    n |= (uint64_t) bytes[i] << (i * 8);
+
+  return true;
+}
+
+} // namespace
+
+namespace primesieve {
+
+/// Extend the index up to stop. If the index has been
+/// built (or loaded) using the same stride, only the
+/// missing entries are computed.
+///
+void PrimePiIndex::build(uint64_t stop, uint64_t stride)
+{
+  if (stride == 0)
+    throw primesieve_error("pi index stride must be > 0");
+
+  if (pi_.empty() || stride_ != stride)
+  {
+    clear();
+    stride_ = stride;
+    pi_.push_back(0);
+  }
+
+  uint64_t size = stop / stride + 1;
+
+  for (uint64_t i = pi_.size(); i < size; i++)
+  {
+    uint64_t count = sieve((i - 1) * stride + 1, i * stride);
+    pi_.push_back(pi_.back() + count);
+  }
+}
+
+void PrimePiIndex::load(const std::string& filename)
+{
+  clear();
+  std::FILE* file = std::fopen(filename.c_str(), "rb");
+  if (!file)
+    throw primesieve_error("failed to open pi index: " + filename);
+
+  char bytes[8];
+  uint64_t stride = 0;
+  uint64_t size = 0;
+  bool isValid = std::fread(bytes, 1, 8, file) == 8 &&
+                 std::equal(bytes, bytes + 8, magic) &&
+                 readUint64(file, stride) &&
+                 readUint64(file, size) &&
+                 stride > 0 &&
+                 size > 0 &&
+                 size - 1 <= std::numeric_limits<uint64_t>::max() / stride;
+
+  if (isValid)
+  {
+    for (uint64_t i = 0; i < size; i++)
+    {
+      uint64_t pi;
+      if (!readUint64(file, pi) ||
+          (i == 0 && pi != 0) ||
+          (i > 0 && pi < pi_.back()))
+      {
+        isValid = false;
+        break;
+      }
+
+      pi_.push_back(pi);
+    }
+
+    isValid = isValid && std::fgetc(file) == EOF;
+  }
+
+  std::fclose(file);
+
+  if (!isValid)
+  {
+    clear();
+    throw primesieve_error("invalid pi index: " + filename);
+  }
+
+  stride_ = stride;
+}
+
+/// The index is first written to a temporary file which
+/// is then renamed. Hence an interrupted save() never
+/// corrupts an existing index.
+///
+void PrimePiIndex::save(const std::string& filename) const
+{
+  std::string tmpFilename = filename + ".tmp";
+  std::FILE* file = std::fopen(tmpFilename.c_str(), "wb");
+  if (!file)
+    throw primesieve_error("failed to create pi index: " + tmpFilename);
+
+  std::fwrite(magic, 1, 8, file);
+  writeUint64(file, stride_);
+  writeUint64(file, pi_.size());
+  for (uint64_t pi : pi_)
+    writeUint64(file, pi);
+
+  bool isError = std::ferror(file) != 0;
+  isError |= std::fclose(file) != 0;
+
+  if (!isError)
+  {
+    // std::rename() fails on Windows if filename exists
+    std::remove(filename.c_str());
+    isError = std::rename(tmpFilename.c_str(), filename.c_str()) != 0;
+  }
+
+  if (isError)
+  {
+    std::remove(tmpFilename.c_str());
+    throw primesieve_error("failed to write pi index: " + filename);
+  }
+}
+
+void PrimePiIndex::clear()
+{
+  Vector<uint64_t> pi;
+  pi_.swap(pi);
+  stride_ = 0;
+}
+
+uint64_t PrimePiIndex::getStop() const
+{
+  if (pi_.empty())
+    return 0;
+  else
+    return (pi_.size() - 1) * stride_;
+}
+
+/// Returns true if counting the primes inside [start, stop]
+/// using the index requires sieving fewer numbers than
+/// counting the primes without the index.
+///
+bool PrimePiIndex::isUseful(uint64_t start, uint64_t stop) const
+{
+  if (pi_.size() < 2 || start > stop)
+    return false;
+
+  uint64_t dist = sieveDistance(stop);
+  if (start > 0)
+    dist += sieveDistance(start - 1);
+
+  return dist < stop - start;
+}
+
+uint64_t PrimePiIndex::countPrimes(uint64_t start, uint64_t stop) const
+{
+  if (start > stop)
+    return 0;
+
+  uint64_t count = primePi(stop);
+  if (start > 0)
+    count -= primePi(start - 1);
+
+  return count;
+}
+
+/// Count the primes <= x using the
+/// index entry nearest to x.
+///
+uint64_t PrimePiIndex::primePi(uint64_t x) const
+{
+  uint64_t stop = getStop();
+  if (x >= stop)
+    return pi_.back() + ((x > stop) ? sieve(stop + 1, x) : 0);
+
+  uint64_t i = x / stride_;
+  uint64_t low = i * stride_;
+
+  if (x - low <= stride_ / 2)
+    return pi_[i] + sieve(low + 1, x);
+  else
+    return pi_[i + 1] - sieve(x + 1, low + stride_);
+}
+
+/// Distance between x and the index entry nearest to x
+uint64_t PrimePiIndex::sieveDistance(uint64_t x) const
+{
+  uint64_t stop = getStop();
+  if (x >= stop)
+    return x - stop;
+
+  uint64_t dist = x % stride_;
+  return std::min(dist, stride_ - dist);
+}
+
+uint64_t PrimePiIndex::sieve(uint64_t start, uint64_t stop) const
+{
+  if (start > stop)
+    return 0;
+
+  ParallelSieve ps;
+  if (threads_)
+    ps.setNumThreads(threads_);
+
+  ps.sieve(start, stop, COUNT_PRIMES);
+  return ps.getCount(0);
+}
+
+} // namespace
@@ -0,0 +1,654 @@
+///
+/// @file   PrimePiLMO.cpp
+/// @brief  Count the primes <= x using the combinatorial
+///         algorithm of Lagarias, Miller and Odlyzko (LMO).
+///         Sieving all numbers <= x takes O(x) operations,
+///         the LMO algorithm only needs O(x^(2/3) / log(x))
+///         operations. Hence for x >= 10^13 counting the primes
+///         using LMO is orders of magnitude faster.
+///
+///         pi(x) = phi(x, a) + a - 1 - P2(x, a), with a = pi(y)
+///         and x^(1/3) <= y < x^(1/2). phi(x, a) counts the
+///         numbers <= x that are not divisible by any of the
+///         first a primes, P2(x, a) counts the numbers <= x that
+///         have exactly 2 prime factors > y.
+///
+///         phi(x, a) = S1 + S2 is computed using the ordinary
+///         leaves S1 and the special leaves S2. The special leaves
+///         are computed by sieving [1, x / y] with the primes <= y
+///         one by one. P2(x, a) requires the prime counts pi(x / p)
+///         for the primes y < p <= x^(1/2) which are computed
+///         using a single pass of ParallelSieve over [x^(1/2), x / y].
+///
+///         All sums are computed modulo 2^64 (unsigned integer
+///         wrap around), pi(x) < 2^64 hence the result is exact.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/PrimePiLMO.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/forward.hpp>
+#include <primesieve/intrinsics.hpp>
+#include <primesieve/iterator.hpp>
+#include <primesieve/macros.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/ThreadPool.hpp>
+#include <primesieve/Vector.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+using namespace primesieve;
+
+/// Sieve array of the special leaves, 1 bit per number
+/// of [low, high[ with low % 64 == 1. The special leaves of
+/// each prime are located in ascending order, hence the
+/// unsieved numbers are counted incrementally using popcnt.
+///
+class PhiSieve
+{
+public:
+  void reset(uint64_t low, uint64_t high)
+  {
+    ASSERT(low % 64 == 1);
+    uint64_t size = high - low;
+    low_ = low;
+    sieve_.resize(ceilDiv(size, 64));
+
+    // Pre-sieve the multiples of 2, 3, 5 and 7
+    const Vector<uint64_t>& pattern = preSieved();
+    std::size_t j = ((low - 1) / 64) % pattern.size();
+
+    for (auto& word : sieve_)
+    {
+      word = pattern[j++];
+      j = (j < pattern.size()) ? j : 0;
+    }
+
+    if (size % 64)
+      sieve_.back() &= (1ull << (size % 64)) - 1;
+
+    total_ = popcount(sieve_.data(), sieve_.size());
+  }
+
+  /// Cross off the odd multiples of prime
+  void crossOff(uint64_t prime)
+  {
+    uint64_t high = low_ + sieve_.size() * 64;
+    uint64_t n = ceilDiv(low_, prime) * prime;
+    n += (n % 2 == 0) ? prime : 0;
+    uint64_t* sieve = sieve_.data();
+    uint64_t total = total_;
+
+    for (uint64_t i = n - low_; i < high - low_; i += prime * 2)
+    {
+      uint64_t word = sieve[i / 64];
+      uint64_t isSet = (word >> (i % 64)) & 1;
+      sieve[i / 64] = word & ~(1ull << (i % 64));
+      total -= isSet;
+    }
+
+    total_ = total;
+  }
+
+  /// Number of unsieved numbers inside [low, high[
+  uint64_t total() const
+  {
+    return total_;
+  }
+
+  void resetCount()
+  {
+    pos_ = 0;
+    count_ = 0;
+  }
+
+  /// Count the unsieved numbers inside [low, n]. n must
+  /// not be smaller than in the previous call since the
+  /// last resetCount().
+  ///
+  uint64_t count(uint64_t n)
+  {
+    uint64_t stop = n - low_ + 1;
+    uint64_t stopWord = stop / 64;
+
+    for (; pos_ < stopWord; pos_++)
+      count_ += popcnt64(sieve_[pos_]);
+
+    uint64_t count = count_;
+    if (stop % 64)
+      count += popcnt64(sieve_[stopWord] & ((1ull << (stop % 64)) - 1));
+
+    return count;
+  }
+
+private:
+  /// Bits of the numbers 1 + i * 64 + j that are
+  /// coprime to 210, the pattern repeats after
+  /// 210 words.
+  ///
+  static const Vector<uint64_t>& preSieved()
+  {
+    static const Vector<uint64_t> pattern = []
+    {
+      Vector<uint64_t> words(210);
+      for (uint64_t i = 0; i < words.size(); i++)
+      {
+        words[i] = 0;
+        for (uint64_t j = 0; j < 64; j++)
+        {
+          uint64_t n = 1 + i * 64 + j;
+          if (n % 2 && n % 3 && n % 5 && n % 7)
+            words[i] |= 1ull << j;
+        }
+      }
+      return words;
+    }();
+
+    return pattern;
+  }
+  uint64_t low_ = 0;
+  uint64_t total_ = 0;
+  /// Words < pos_ have been counted
+  uint64_t pos_ = 0;
+  uint64_t count_ = 0;
+  Vector<uint64_t> sieve_;
+};
+
+/// 2, 3, 5 and 7 are pre-sieved
+constexpr std::size_t PHI_TINY_PRIMES = 4;
+
+/// phi(n, c) for c <= 3: the count of numbers <= n
+/// that are not divisible by any of the first c primes.
+/// phi(n, c) = (n / pp) * phi(pp, c) + phi(n % pp, c)
+/// with pp the product of the first c primes.
+///
+uint64_t phiTiny(uint64_t n, std::size_t c)
+{
+  static const uint64_t pp[4] = { 1, 2, 6, 30 };
+  static const uint64_t totient[4] = { 1, 1, 2, 8 };
+  static const uint8_t phi30[30] =
+  {
+    0, 1, 1, 1, 1, 1, 1, 2, 2, 2,
+    2, 3, 3, 4, 4, 4, 4, 5, 5, 6,
+    6, 6, 6, 7, 7, 7, 7, 7, 7, 8
+  };
+
+  ASSERT(c <= 3);
+  uint64_t r = n % pp[c];
+  uint64_t phi = (n / pp[c]) * totient[c];
+
+  if (c == 1)
+    phi += r;
+  else if (c == 2)
+    phi += (r >= 1) + (r >= 5);
+  else if (c == 3)
+    phi += phi30[r];
+
+  return phi;
+}
+
+/// Special leaves of the numbers inside [low, high[
+struct Chunk
+{
+  uint64_t low;
+  uint64_t high;
+  /// Sum of the special leaves without the phi(low - 1, b - 1)
+  /// parts, these are added when the chunks are merged.
+  uint64_t sum;
+  /// Sum of mu(m) of the special leaves of the bth prime
+  Vector<int64_t> muSum;
+  /// Unsieved numbers of [low, high[ after sieving
+  /// with the first b - 1 primes.
+  Vector<uint64_t> phi;
+};
+
+inline uint64_t fastDiv(uint64_t x, uint64_t y)
+{
+  if (x >= (1ull << 52))
+    return x / y;
+  uint64_t q = (uint64_t) ((double) x / (double) y);
+  if (q * y > x)
+    q--;
+  else if ((q + 1) * y <= x)
+    q++;
+  return q;
+}
+
+uint64_t icbrt(uint64_t x)
+{
+  uint64_t r = (uint64_t) std::cbrt((double) x);
+
+  // Fix the rounding error of std::cbrt()
+  while (r > 0 && r * r * r > x)
+    r--;
+  // (2642245 + 1)^3 > 2^64 - 1
+  while (r < 2642245 &&
+         (r + 1) * (r + 1) * (r + 1) <= x)
+    r++;
+
+  return r;
+}
+
+/// The LMO algorithm is fastest if y = alpha * x^(1/3)
+/// with alpha growing slowly with x.
+///
+uint64_t getY(uint64_t x)
+{
+  double logx = std::log((double) x);
+  double alpha = std::max(1.0, logx * logx * config::LMO_ALPHA);
+  uint64_t cbrtx = icbrt(x);
+  uint64_t y = (uint64_t) (cbrtx * alpha);
+
+  // x^(1/3) <= y < x^(1/2) is required
+  y = std::max(y, cbrtx);
+  y = std::min(y, isqrt(x) - 1);
+
+  return y;
+}
+
+/// mu(n) * lpf(n) for n <= y, with mu(n) the Möbius function
+/// and lpf(n) the least prime factor of n. 0 if n is not
+/// square free and lpf(1) = +Infinity.
+///
+Vector<int32_t> generateMuLpf(const Vector<uint64_t>& primes, uint64_t y)
+{
+  Vector<int32_t> muLpf(y + 1);
+  std::fill(muLpf.begin(), muLpf.end(), 1);
+  muLpf[1] = std::numeric_limits<int32_t>::max();
+
+  // Iterate over the primes in descending order,
+  // hence lpf(n) is set last.
+  for (std::size_t i = primes.size() - 1; i >= 1; i--)
+  {
+    int32_t prime = (int32_t) primes[i];
+    for (uint64_t n = prime; n <= y; n += prime)
+      muLpf[n] = (muLpf[n] > 0) ? -prime : prime;
+  }
+
+  for (std::size_t i = 1; i < primes.size(); i++)
+  {
+    uint64_t square = primes[i] * primes[i];
+    if (square > y)
+      break;
+    for (uint64_t n = square; n <= y; n += square)
+      muLpf[n] = 0;
+  }
+
+  return muLpf;
+}
+
+/// Ordinary leaves: S1 = sum_{n <= y} mu(n) * x / n
+uint64_t S1(uint64_t x, const Vector<int32_t>& muLpf)
+{
+  uint64_t sum = 0;
+
+  for (uint64_t n = 1; n < muLpf.size(); n++)
+  {
+    if (muLpf[n] > 0)
+      sum += x / n;
+    else if (muLpf[n] < 0)
+      sum -= x / n;
+  }
+
+  return sum;
+}
+
+/// Compute the special leaves -mu(m) * phi(x / (p_b * m), b - 1)
+/// with x / (p_b * m) inside [chunk.low, chunk.high[.
+///
+void S2Chunk(uint64_t x,
+             uint64_t y,
+             uint64_t segmentSize,
+             const Vector<uint64_t>& primes,
+             const Vector<int32_t>& muLpf,
+             PhiSieve& sieve,
+             Chunk& chunk)
+{
+  std::size_t a = primes.size() - 1;
+  chunk.sum = 0;
+  chunk.muSum.resize(a + 1);
+  chunk.phi.resize(a + 1);
+  std::fill(chunk.muSum.begin(), chunk.muSum.end(), 0);
+  std::fill(chunk.phi.begin(), chunk.phi.end(), 0);
+
+  for (uint64_t low = chunk.low; low < chunk.high; low += segmentSize)
+  {
+    uint64_t high = std::min(low + segmentSize, chunk.high);
+    sieve.reset(low, high);
+
+    for (std::size_t b = PHI_TINY_PRIMES + 1; b < a; b++)
+    {
+      uint64_t prime = primes[b];
+      uint64_t xp = x / prime;
+      uint64_t minM = std::max(xp / high, y / prime);
+      uint64_t maxM = std::min(xp / low, y);
+
+      // The special leaves require lpf(m) > prime.
+      // maxM decreases with low, hence the primes
+      // >= primes[b] have no more special leaves.
+      if (prime >= maxM)
+        break;
+
+      sieve.resetCount();
+      uint64_t phi = chunk.phi[b];
+      int64_t muSum = 0;
+      uint64_t sum = 0;
+
+      if (prime * prime <= y)
+      {
+        for (uint64_t m = maxM; m > minM; m--)
+        {
+          int32_t v = muLpf[m];
+          if (v > 0 && (uint64_t) v > prime)
+          {
+            sum -= phi + sieve.count(xp / m);
+            muSum += 1;
+          }
+          else if (v < 0 && (uint64_t) -(int64_t) v > prime)
+          {
+            sum += phi + sieve.count(xp / m);
+            muSum -= 1;
+          }
+        }
+      }
+      else
+      {
+        // m <= y < prime^2 and lpf(m) > prime, hence
+        // m is a prime > prime and mu(m) = -1. The easy
+        // leaves with m > x / (prime * min(prime^2, y + 1))
+        // are computed by S2Easy().
+        maxM = std::min(maxM, xp / std::min(prime * prime, y + 1));
+        std::size_t l = std::upper_bound(&primes[b + 1], primes.end(), maxM) - &primes[1];
+        uint64_t minQ = std::max(minM, prime);
+
+        for (; primes[l] > minQ; l--)
+        {
+          sum += phi + sieve.count(xp / primes[l]);
+          muSum -= 1;
+        }
+      }
+
+      chunk.sum += sum;
+      chunk.muSum[b] += muSum;
+      chunk.phi[b] += sieve.total();
+      sieve.crossOff(prime);
+    }
+  }
+}
+
+/// Easy special leaves: phi(x / (p_b * q), b - 1) with q a
+/// prime and x / (p_b * q) < min(p_b^2, y + 1). All numbers
+/// <= x / (p_b * q) that are not divisible by the first b - 1
+/// primes are 1 and the primes >= p_b, hence the easy leaves
+/// are computed using a lookup table of pi(n) with n <= y.
+///
+uint64_t S2Easy(uint64_t x,
+                uint64_t y,
+                const Vector<uint64_t>& primes,
+                int threads)
+{
+  Vector<uint32_t> pi(y + 1);
+  std::fill(pi.begin(), pi.end(), 0);
+  for (std::size_t i = 1; i < primes.size(); i++)
+    pi[primes[i]] = (uint32_t) i;
+  for (uint64_t n = 1; n <= y; n++)
+    pi[n] = std::max(pi[n], pi[n - 1]);
+
+  std::size_t a = primes.size() - 1;
+  std::size_t first = 1;
+  while (first < a && primes[first] * primes[first] <= y)
+    first++;
+
+  Vector<uint64_t> sums(threads);
+  std::fill(sums.begin(), sums.end(), 0);
+
+  ThreadPool::get().run(threads, [&](int i)
+  {
+    uint64_t sum = 0;
+
+    for (std::size_t b = first + i; b < a; b += threads)
+    {
+      uint64_t prime = primes[b];
+      uint64_t xp = x / prime;
+      uint64_t minQ = std::max(prime, xp / std::min(prime * prime, y + 1));
+
+      if (minQ >= y)
+        continue;
+
+      // phi(x / (prime * q), b - 1) = 1 + the number of
+      // primes p_k with k >= b and p_k <= x / (prime * q).
+      uint64_t piMinQ = pi[minQ];
+      uint64_t maxZ = xp / (minQ + 1);
+      uint64_t qs = a - piMinQ;
+      sum += qs;
+
+      if (maxZ < prime)
+        continue;
+
+      // Either iterate over the primes q or over the
+      // primes p_k, whichever is fewer. For each p_k we
+      // count the primes q <= x / (prime * p_k).
+      uint64_t ks = pi[maxZ] - b + 1;
+
+      if (ks < qs)
+      {
+        for (std::size_t k = b; k <= pi[maxZ]; k++)
+          sum += pi[std::min(fastDiv(xp, primes[k]), y)] - piMinQ;
+      }
+      else
+      {
+        for (std::size_t l = a; l > piMinQ; l--)
+        {
+          uint64_t n = pi[fastDiv(xp, primes[l])];
+          sum += (n >= b) ? n - b + 1 : 0;
+        }
+      }
+    }
+
+    sums[i] = sum;
+  });
+
+  uint64_t sum = 0;
+  for (uint64_t n : sums)
+    sum += n;
+
+  return sum;
+}
+
+/// Special leaves: S2 = -sum mu(m) * phi(x / (p_b * m), b - 1)
+/// for all square free m with lpf(m) > p_b and m <= y < p_b * m.
+/// [1, x / y] is split into chunks that are sieved in parallel,
+/// the chunks of each round are merged in ascending order.
+///
+uint64_t S2(uint64_t x,
+            uint64_t y,
+            const Vector<uint64_t>& primes,
+            const Vector<int32_t>& muLpf,
+            int threads)
+{
+  uint64_t limit = x / y + 1;
+  uint64_t segmentSize = std::max(isqrt(limit), config::MIN_LMO_SEGMENT_SIZE);
+  segmentSize = ceilDiv(segmentSize, 1024) * 1024;
+  uint64_t segments = ceilDiv(limit - 1, segmentSize);
+  threads = (int) std::min((uint64_t) threads, segments);
+
+  uint64_t sum = S2Easy(x, y, primes, threads);
+
+  // The special leaves of the first PHI_TINY_PRIMES primes
+  // are computed using phiTiny(), these primes are
+  // pre-sieved in the sieve array.
+  for (std::size_t b = 1; b <= PHI_TINY_PRIMES; b++)
+  {
+    uint64_t prime = primes[b];
+
+    for (uint64_t m = y / prime + 1; m <= y; m++)
+    {
+      int32_t v = muLpf[m];
+      if (v > 0 && (uint64_t) v > prime)
+        sum -= phiTiny(x / prime / m, b - 1);
+      else if (v < 0 && (uint64_t) -(int64_t) v > prime)
+        sum += phiTiny(x / prime / m, b - 1);
+    }
+  }
+
+  // The sieve segments must start at a number n
+  // with n % 64 == 1 (pre-sieved pattern).
+  Vector<uint64_t> phi(primes.size());
+  Vector<Chunk> chunks(threads);
+  Vector<PhiSieve> sieves(threads);
+  std::fill(phi.begin(), phi.end(), 0);
+  uint64_t low = 1;
+
+  // Most special leaves are located near the beginning
+  // of the interval, hence we start with small chunks.
+  uint64_t chunkSegments = 1;
+
+  while (low < limit)
+  {
+    int tasks = 0;
+
+    for (; tasks < threads && low < limit; tasks++)
+    {
+      uint64_t dist = chunkSegments * segmentSize;
+      chunks[tasks].low = low;
+      chunks[tasks].high = (limit - low > dist) ? low + dist : limit;
+      low = chunks[tasks].high;
+    }
+
+    ThreadPool::get().run(tasks, [&](int i)
+    {
+      S2Chunk(x, y, segmentSize, primes, muLpf, sieves[i], chunks[i]);
+    });
+
+    for (int i = 0; i < tasks; i++)
+    {
+      Chunk& chunk = chunks[i];
+      sum += chunk.sum;
+
+      for (std::size_t b = 1; b < phi.size(); b++)
+      {
+        sum -= (uint64_t) chunk.muSum[b] * phi[b];
+        phi[b] += chunk.phi[b];
+      }
+    }
+
+    chunkSegments = std::min(chunkSegments * 2, config::MAX_LMO_CHUNK_SEGMENTS);
+  }
+
+  return sum;
+}
+
+/// P2(x, a) = sum_{y < p <= x^(1/2)} pi(x / p) - pi(p) + 1.
+/// The primes are processed in descending order, hence
+/// x / p is ascending and the prime counts pi(x / p) of
+/// many primes are computed using a single pass of
+/// ParallelSieve::countPrefixes().
+///
+uint64_t P2(uint64_t x, uint64_t y, uint64_t a, int threads)
+{
+  uint64_t sqrtx = isqrt(x);
+  if (y >= sqrtx)
+    return 0;
+
+  primesieve::iterator it(sqrtx);
+  Vector<uint64_t> stops;
+  Vector<uint64_t> counts;
+  uint64_t sum = 0;
+  uint64_t primes = 0;
+  uint64_t start = sqrtx + 1;
+  uint64_t carry = 0;
+  uint64_t prime = it.prev_prime();
+
+  // sum = sum_{y < p <= x^(1/2)} pi(x / p) - pi(x^(1/2))
+  while (prime > y)
+  {
+    stops.clear();
+    while (prime > y && stops.size() < config::LMO_P2_STOPS)
+    {
+      stops.push_back(x / prime);
+      prime = it.prev_prime();
+    }
+
+    counts.resize(stops.size());
+    ParallelSieve ps;
+    ps.setNumThreads(threads);
+    ps.setStart(start);
+    ps.setStop(stops.back());
+    ps.countPrefixes(stops.data(), stops.size(), counts.data());
+
+    for (uint64_t count : counts)
+      sum += carry + count;
+
+    carry += counts.back();
+    start = stops.back() + 1;
+    primes += stops.size();
+  }
+
+  // b = pi(p) for the primes y < p <= x^(1/2)
+  uint64_t pi_sqrtx = a + primes;
+  sum += primes * pi_sqrtx;
+  sum -= (pi_sqrtx * (pi_sqrtx - 1) - a * (a - 1)) / 2;
+
+  return sum;
+}
+
+} // namespace
+
+namespace primesieve {
+
+/// Count the primes <= x using the LMO algorithm
+uint64_t primePiLMO(uint64_t x, int threads)
+{
+  if (x < config::MIN_LMO)
+  {
+    ParallelSieve ps;
+    ps.setNumThreads(threads);
+    ps.sieve(0, x, COUNT_PRIMES);
+    return ps.getCount(0);
+  }
+
+  uint64_t y = getY(x);
+  Vector<uint64_t> primes;
+  primes.push_back(0);
+  primesieve::iterator it;
+
+  for (uint64_t prime = it.next_prime(); prime <= y; prime = it.next_prime())
+    primes.push_back(prime);
+
+  uint64_t a = primes.size() - 1;
+  Vector<int32_t> muLpf = generateMuLpf(primes, y);
+  uint64_t phi = S1(x, muLpf);
+  phi += S2(x, y, primes, muLpf, threads);
+
+  return phi + a - 1 - P2(x, y, a, threads);
+}
+
+/// Counting the primes inside [start, stop] using
+/// pi(stop) - pi(start - 1) is faster than sieving if the
+/// interval is much larger than the number of operations
+/// of the LMO algorithm, that is about (stop^(2/3)).
+///
+bool isPrimePiLMOUseful(uint64_t start, uint64_t stop)
+{
+  if (stop < config::MIN_LMO ||
+      start > stop)
+    return false;
+
+  double cost = std::pow((double) stop, 2.0 / 3.0);
+  if (start >= config::MIN_LMO)
+    cost += std::pow((double) start, 2.0 / 3.0);
+
+  return (stop - start) > cost * config::LMO_SPEEDUP;
+}
+
+} // namespace
@@ -12,8 +12,11 @@
 
 #include <primesieve/forward.hpp>
 #include <primesieve/PrimeSieve.hpp>
+#include <primesieve/PrintBuffer.hpp>
 #include <primesieve/ParallelSieve.hpp>
 #include <primesieve/CountPrintPrimes.hpp>
+#include <primesieve/macros.hpp>
+#include <primesieve/MemoryPool.hpp>
 #include <primesieve/pmath.hpp>
 #include <primesieve/Vector.hpp>
 #include <primesieve/PreSieve.hpp>
@@ -21,6 +24,8 @@
 #include <stdint.h>
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <string>
 
@@ -155,6 +160,11 @@ int PrimeSieve::getSieveSize() const
   return sieveSize_;
 }
 
+int PrimeSieve::getFlags() const
+{
+  return flags_;
+}
+
 double PrimeSieve::getSeconds() const
 {
   return seconds_;
@@ -165,11 +175,85 @@ PreSieve& PrimeSieve::getPreSieve()
   return preSieve_;
 }
 
+Vector<char>* PrimeSieve::getPrintOutput() const
+{
+  return printOutput_;
+}
+
+const PrimePiIndex* PrimeSieve::getPiIndex() const
+{
+  return piIndex_;
+}
+
+MemoryPool& PrimeSieve::getMemoryPool()
+{
+  return memoryPool_;
+}
+
+/// Worker threads of ParallelSieve may continue sieving
+/// the next adjacent chunk, up to the parent's stop.
+///
+uint64_t PrimeSieve::getMaxStop() const
+{
+  if (nextChunk_ && parent_)
+    return std::max(stop_, parent_->getStop());
+  else
+    return stop_;
+}
+
+void PrimeSieve::setNextChunk(const std::function<bool(uint64_t&)>* nextChunk)
+{
+  nextChunk_ = nextChunk;
+}
+
+void PrimeSieve::setPiIndex(const PrimePiIndex* piIndex)
+{
+  piIndex_ = piIndex;
+}
+
+/// If the next chunk of this worker thread is adjacent
+/// to the current chunk, then increase stop_ to the
+/// stop number of the next chunk.
+///
+bool PrimeSieve::nextChunk()
+{
+  uint64_t stop = stop_;
+
+  if (!nextChunk_ ||
+      !(*nextChunk_)(stop))
+    return false;
+
+  ASSERT(stop > stop_);
+  ASSERT(stop <= getMaxStop());
+  stop_ = stop;
+  return true;
+}
+
+/// Worker threads read their sieving primes from
+/// the parent's shared table (if any).
+///
+const SievingPrimesTable* PrimeSieve::getSievingPrimesTable() const
+{
+  if (parent_)
+    return parent_->getSievingPrimesTable();
+  else
+    return nullptr;
+}
+
 void PrimeSieve::setFlags(int flags)
 {
   flags_ = flags;
 }
 
+/// Used by ParallelSieve to print primes in
+/// parallel, each thread prints its primes into
+/// a buffer which are then printed in order.
+///
+void PrimeSieve::setPrintOutput(Vector<char>* printOutput)
+{
+  printOutput_ = printOutput;
+}
+
 void PrimeSieve::addFlags(int flags)
 {
   flags_ |= flags;
@@ -243,6 +327,8 @@ void PrimeSieve::printStatus(double old, double current)
 /// Process small primes <= 5 and small k-tuplets <= 17
 void PrimeSieve::processSmallPrimes()
 {
+  PrintBuffer printBuffer(flags_, 0, printOutput_);
+
   for (auto& p : smallPrimes)
   {
     if (p.first >= start_ && p.last <= stop_)
@@ -250,7 +336,18 @@ void PrimeSieve::processSmallPrimes()
       if (isCount(p.index))
         counts_[p.index]++;
       if (isPrint(p.index))
-        std::cout << p.str << '\n';
+      {
+        // The bitmap format only contains primes >= 7
+        if (p.index == 0 && printBuffer.getFormat() == PRINT_BITMAP)
+          continue;
+        if (p.index == 0)
+          printBuffer.print(p.first);
+        else
+        {
+          printBuffer.write(p.str, std::strlen(p.str));
+          printBuffer.write("\n", 1);
+        }
+      }
     }
   }
 }
@@ -23,6 +23,7 @@
 #include <primesieve/Vector.hpp>
 
 #include <stdint.h>
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -268,6 +269,45 @@ T RiemannR_inverse(T x)
   return t;
 }
 
+/// Calculate the logarithmic integral using the series
+/// li(x) = gamma + log(log(x)) + \sum_{k=1}^{∞} log(x)^k / (k * k!)
+/// All terms are positive, hence there is no cancellation.
+///
+template <typename T>
+T li(T x)
+{
+  if (x <= 1)
+    return 0;
+
+  const T gamma = T(0.577215664901532860606512090082402431L);
+  T epsilon = std::numeric_limits<T>::epsilon();
+  T logx = std::log(x);
+  T sum = 0;
+  T term = 1;
+
+  for (unsigned k = 1; k < 1000; k++)
+  {
+    term *= logx / k;
+    T old_sum = sum;
+    sum += term / k;
+
+    // Not converging anymore
+    if (std::abs(sum - old_sum) <= epsilon * sum)
+      break;
+  }
+
+  return gamma + std::log(logx) + sum;
+}
+
+/// The bounds below are computed using floating point
+/// arithmetic, we widen them by a tiny relative error
+/// so that they remain valid despite rounding errors.
+///
+long double roundingError(long double x)
+{
+  return x * 1e-14L + 2;
+}
+
 } // namespace
 
 namespace primesieve {
@@ -316,4 +356,125 @@ uint64_t nthPrimeApprox(uint64_t n)
   return (uint64_t) res;
 }
 
+/// Rigorous lower bound of PrimePi(x).
+/// For 2 <= x <= 10^19 we use Büthe's bound:
+/// PrimePi(x) >= li(x) - sqrt(x) / log(x) * (1.95 + 3.9 / log(x) + 19.5 / log(x)^2).
+/// Jan Büthe, "Estimating pi(x) and related functions under
+/// partial RH assumptions", Math. Comp. 85 (2016), Theorem 2.
+/// For x > 10^19 we use Dusart's bound:
+/// PrimePi(x) >= x / log(x) * (1 + 1 / log(x) + 2 / log(x)^2).
+/// Pierre Dusart, "Estimates of some functions over primes
+/// without R.H.", arXiv:1002.0442 (2010), Theorem 6.9.
+///
+uint64_t primePiLower(uint64_t x)
+{
+  if (x < 2)
+    return 0;
+
+  long double lx = (long double) x;
+  long double logx = std::log(lx);
+  long double lower;
+
+  if (x <= 10000000000000000000ull)
+  {
+    long double sqrtx = std::sqrt(lx);
+    lower = li(lx) - sqrtx / logx * (1.95L + 3.9L / logx + 19.5L / (logx * logx));
+  }
+  else
+    lower = lx / logx * (1 + 1 / logx + 2 / (logx * logx));
+
+  lower -= roundingError(lower);
+
+  if (lower <= 0)
+    return 0;
+
+  return (uint64_t) lower;
+}
+
+/// Rigorous upper bound of PrimePi(x).
+/// For 2 <= x <= 10^19 we use PrimePi(x) < li(x), Büthe (2016).
+/// For x > 10^19 we use Dusart's bound:
+/// PrimePi(x) <= x / log(x) * (1 + 1 / log(x) + 2.334 / log(x)^2).
+///
+uint64_t primePiUpper(uint64_t x)
+{
+  if (x < 2)
+    return 0;
+
+  long double lx = (long double) x;
+  long double logx = std::log(lx);
+  long double upper;
+
+  if (x <= 10000000000000000000ull)
+    upper = li(lx);
+  else
+    upper = lx / logx * (1 + 1 / logx + 2.334L / (logx * logx));
+
+  upper += roundingError(upper);
+
+  // PrimePi(x) <= x / 2 + 1
+  upper = std::min(upper, lx / 2 + 1);
+
+  return (uint64_t) upper;
+}
+
+/// Rigorous lower bound of the nth prime,
+/// the smallest x with primePiUpper(x) >= n.
+///
+uint64_t nthPrimeLower(uint64_t n)
+{
+  if (n <= 1)
+    return 2;
+
+  // Binary search, primePiUpper(x) is increasing
+  uint64_t low = 2;
+  uint64_t high = std::numeric_limits<uint64_t>::max();
+
+  if (primePiUpper(high) < n)
+    return high;
+
+  // primePiUpper(low) < n <= primePiUpper(high)
+  while (high - low > 1)
+  {
+    uint64_t mid = low + (high - low) / 2;
+    if (primePiUpper(mid) < n)
+      low = mid;
+    else
+      high = mid;
+  }
+
+  // PrimePi(low) < n, hence nth prime > low
+  return high;
+}
+
+/// Rigorous upper bound of the nth prime,
+/// the smallest x with primePiLower(x) >= n.
+/// Returns 2^64 - 1 if the bound is > 2^64 - 1.
+///
+uint64_t nthPrimeUpper(uint64_t n)
+{
+  if (n <= 1)
+    return 2;
+
+  // Binary search, primePiLower(x) is increasing
+  uint64_t low = 2;
+  uint64_t high = std::numeric_limits<uint64_t>::max();
+
+  if (primePiLower(high) < n)
+    return high;
+
+  // primePiLower(low) < n <= primePiLower(high)
+  while (high - low > 1)
+  {
+    uint64_t mid = low + (high - low) / 2;
+    if (primePiLower(mid) < n)
+      low = mid;
+    else
+      high = mid;
+  }
+
+  // PrimePi(high) >= n, hence nth prime <= high
+  return high;
+}
+
 } // namespace
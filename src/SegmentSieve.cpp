@@ -0,0 +1,66 @@
+///
+/// @file   SegmentSieve.cpp
+/// @brief  SegmentSieve gives read-only access to the sieve array
+///         of each segment. Each byte of the sieve array
+///         corresponds to 30 numbers and its 8 bits correspond
+///         to the offsets { 7, 11, 13, 17, 19, 23, 29, 31 }.
+///         Decoding the primes is left to the caller.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/SegmentSieve.hpp>
+#include <primesieve/Erat.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/PreSieve.hpp>
+#include <primesieve/PrimeSieve.hpp>
+#include <primesieve/SievingPrimes.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+
+namespace primesieve {
+
+SegmentSieve::SegmentSieve(PrimeSieve& ps) :
+  ps_(ps),
+  memoryPool_(ps.getMemoryPool())
+{
+  uint64_t start = ps.getStart();
+  uint64_t stop = ps.getStop();
+  uint64_t sieveSize = ps.getSieveSize();
+  start = std::max<uint64_t>(start, 7);
+
+  // Reuse the buckets of the previous SegmentSieve
+  memoryPool_.reset();
+  ps.getPreSieve().init(start, stop);
+  Erat::init(start, stop, sieveSize, ps.getPreSieve(), memoryPool_);
+}
+
+/// Calls callback(sieve, size, low) for each segment.
+/// Bits corresponding to numbers outside [start, stop] are
+/// unset. The sieve array is padded with zero bytes to a
+/// multiple of 8 bytes.
+///
+void SegmentSieve::sieve(const SegmentCallback& callback)
+{
+  uint64_t sieveSize = ps_.getSieveSize();
+  SievingPrimes sievingPrimes(this, sieveSize, ps_.getPreSieve(), memoryPool_, ps_.getSievingPrimesTable());
+  uint64_t prime = sievingPrimes.next();
+
+  while (hasNextSegment())
+  {
+    uint64_t low = segmentLow_;
+    uint64_t sqrtHigh = isqrt(segmentHigh_);
+
+    for (; prime <= sqrtHigh; prime = sievingPrimes.next())
+      addSievingPrime(prime);
+
+    sieveSegment();
+    callback(sieve_.data(), sieve_.size(), low);
+  }
+}
+
+} // namespace
@@ -11,6 +11,7 @@
 #include <primesieve/SievingPrimes.hpp>
 #include <primesieve/Erat.hpp>
 #include <primesieve/PreSieve.hpp>
+#include <primesieve/SievingPrimesTable.hpp>
 #include <primesieve/littleendian_cast.hpp>
 #include <primesieve/macros.hpp>
 #include <primesieve/pmath.hpp>
@@ -23,19 +24,30 @@ namespace primesieve {
 SievingPrimes::SievingPrimes(Erat* erat,
                              uint64_t sieveSize,
                              PreSieve& preSieve,
-                             MemoryPool& memoryPool)
+                             MemoryPool& memoryPool,
+                             const SievingPrimesTable* table)
 {
-  init(erat, sieveSize, preSieve, memoryPool);
+  init(erat, sieveSize, preSieve, memoryPool, table);
 }
 
 void SievingPrimes::init(Erat* erat,
                          uint64_t sieveSize,
                          PreSieve& preSieve,
-                         MemoryPool& memoryPool)
+                         MemoryPool& memoryPool,
+                         const SievingPrimesTable* table)
 {
   ASSERT(preSieve.getMaxPrime() >= 7);
   uint64_t start = preSieve.getMaxPrime() + 2;
-  uint64_t stop = isqrt(erat->getStop());
+  uint64_t stop = isqrt(erat->getMaxStop());
+  table_ = table;
+
+  if (table)
+  {
+    ASSERT(table->getStop() >= stop);
+    initTable(start);
+    return;
+  }
+
   Erat::init(start, stop, sieveSize, preSieve, memoryPool);
 
   ASSERT(start % 2 == 1);
@@ -59,15 +71,38 @@ void SievingPrimes::tinySieve()
         tinySieve_[j] = false;
 }
 
+/// Read the sieving primes >= start from the shared
+/// SievingPrimesTable instead of sieving them.
+///
+void SievingPrimes::initTable(uint64_t start)
+{
+  sieveData_ = table_->data();
+  sieveSize_ = table_->size();
+  sieveIdx_ = sieveSize_;
+
+  if (start - 7 < sieveSize_ * 30)
+  {
+    // The table is read in steps of 8 bytes
+    sieveIdx_ = ((start - 7) / 30) & ~7ull;
+    low_ = sieveIdx_ * 30;
+  }
+
+  // Skip the primes < start, these
+  // are handled by pre-sieving.
+  while (next() < start);
+  i_--;
+}
+
 void SievingPrimes::fill()
 {
-  if (sieveIdx_ >= sieve_.size())
+  if (sieveIdx_ >= sieveSize_)
     if (!sieveSegment())
       return;
 
   size_t num = 0;
   uint64_t low = low_;
-  uint64_t sieveSize = sieve_.size();
+  uint64_t sieveSize = sieveSize_;
+  const uint8_t* sieve = sieveData_;
   ASSERT(primes_.size() >= 64);
 
   // Fill the buffer with at least (primes_.size() - 64) primes.
@@ -76,7 +111,7 @@ void SievingPrimes::fill()
   // not enough space for 64 more primes.
   do
   {
-      uint64_t bits = littleendian_cast<uint64_t>(&sieve_[sieveIdx_]);
+      uint64_t bits = littleendian_cast<uint64_t>(&sieve[sieveIdx_]);
       size_t j = num;
       num += popcnt64(bits);
 
@@ -103,7 +138,10 @@ void SievingPrimes::fill()
 
 bool SievingPrimes::sieveSegment()
 {
-  if (hasNextSegment())
+  // The shared table contains all sieving
+  // primes, there is no next segment.
+  if (!table_ &&
+      hasNextSegment())
   {
     sieveIdx_ = 0;
     uint64_t high = segmentHigh_;
@@ -113,6 +151,8 @@ bool SievingPrimes::sieveSegment()
         addSievingPrime(i);
 
     Erat::sieveSegment();
+    sieveData_ = sieve_.data();
+    sieveSize_ = sieve_.size();
     return true;
   }
   else
@@ -0,0 +1,89 @@
+///
+/// @file   SievingPrimesTable.cpp
+/// @brief  ParallelSieve splits the sieving interval into many
+///         chunks. Without a shared table each chunk would have
+///         to re-sieve all sieving primes <= sqrt(stop) from
+///         scratch. Instead the sieving primes are generated
+///         only once (in parallel) and stored in a compact
+///         read-only bit table which is shared by all threads.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/SievingPrimesTable.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/macros.hpp>
+#include <primesieve/pmath.hpp>
+#include <primesieve/PrimeSieve.hpp>
+#include <primesieve/SegmentSieve.hpp>
+#include <primesieve/ThreadPool.hpp>
+#include <primesieve/Vector.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+
+namespace primesieve {
+
+/// Generate the primes inside [7, stop] using
+/// up to threads threads.
+///
+void SievingPrimesTable::init(uint64_t stop, int threads)
+{
+  if (!table_.empty() && stop_ == stop)
+    return;
+
+  clear();
+  if (stop < 7)
+    return;
+
+  // Each thread sieves a multiple of 8 bytes, hence the
+  // threads never write to the same 64-bit word.
+  uint64_t bytes = (stop - 7) / 30 + 1;
+  bytes = ceilDiv(bytes, 8) * 8;
+  uint64_t minBytes = ceilDiv(config::MIN_THREAD_DISTANCE / 30, 8) * 8;
+  uint64_t threadBytes = ceilDiv(bytes / 8, std::max(threads, 1)) * 8;
+  threadBytes = std::max(threadBytes, minBytes);
+  uint64_t iters = ceilDiv(bytes, threadBytes);
+
+  table_.resize(bytes);
+  std::fill_n(table_.data(), bytes, (uint8_t) 0);
+
+  auto task = [&](int i)
+  {
+    uint64_t first = i * threadBytes;
+    uint64_t last = std::min(first + threadBytes, bytes);
+    uint64_t low = first * 30 + 7;
+    uint64_t high = std::min(last * 30 + 6, stop);
+
+    PrimeSieve ps;
+    ps.setStart(low);
+    ps.setStop(high);
+    SegmentSieve segmentSieve(ps);
+    segmentSieve.sieve([&](const uint8_t* sieve, std::size_t size, uint64_t segmentLow)
+    {
+      ASSERT(segmentLow % 30 == 0);
+      uint64_t j = segmentLow / 30;
+      ASSERT(j >= first && j < last);
+      size = (std::size_t) std::min<uint64_t>(size, last - j);
+      std::memcpy(&table_[j], sieve, size);
+    });
+  };
+
+  ThreadPool::get().run((int) iters, task);
+  stop_ = stop;
+}
+
+void SievingPrimesTable::clear()
+{
+  Vector<uint8_t> table;
+  table_.swap(table);
+  stop_ = 0;
+}
+
+} // namespace
@@ -0,0 +1,284 @@
+///
+/// @file   ThreadPool.cpp
+/// @brief  Creating new threads for each parallel computation
+///         adds significant latency when many mid-size
+///         computations are run. Hence ParallelSieve runs its
+///         tasks on a process-wide pool of worker threads.
+///
+///         The thread calling run() also executes the tasks of
+///         its own job. Hence run() may also be called from
+///         multiple threads simultaneously and it may even be
+///         called recursively (from within a task) without
+///         risk of deadlock. Note that the tasks must not wait
+///         for each other: all tasks of ParallelSieve fetch
+///         their work dynamically, so a job completes even if
+///         its tasks are executed one after another.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/ThreadPool.hpp>
+#include <primesieve/CpuInfo.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/macros.hpp>
+#include <primesieve/Vector.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && \
+    __has_include(<pthread.h>) && \
+    __has_include(<sched.h>)
+  #include <pthread.h>
+  #include <sched.h>
+  #define HAS_PTHREAD_AFFINITY
+#endif
+
+namespace {
+
+#if defined(HAS_PTHREAD_AFFINITY)
+
+struct PinCpus
+{
+  /// CPUs of the process' affinity mask
+  cpu_set_t allowed;
+  /// The NUMA nodes take turns: 1st CPU of node 0, 1st CPU
+  /// of node 1, ..., 2nd CPU of node 0, ... Hence if there
+  /// are fewer threads than CPU cores, the threads use the
+  /// caches and memory bandwidth of all NUMA nodes.
+  primesieve::Vector<int> cpus;
+};
+
+const PinCpus& getPinCpus()
+{
+  static const PinCpus pinCpus = []
+  {
+    PinCpus res;
+    CPU_ZERO(&res.allowed);
+    if (sched_getaffinity(0, sizeof(res.allowed), &res.allowed) != 0)
+      return res;
+
+    std::vector<std::vector<int>> nodes;
+    const auto& cpuInfo = primesieve::cpuInfo;
+
+    for (std::size_t node = 0; node < cpuInfo.numaNodes(); node++)
+    {
+      nodes.emplace_back();
+      for (std::size_t cpu : cpuInfo.numaNodeCpus(node))
+        if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &res.allowed))
+          nodes.back().push_back((int) cpu);
+    }
+
+    // NUMA topology unknown
+    if (nodes.empty())
+    {
+      nodes.emplace_back();
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, &res.allowed))
+          nodes.back().push_back(cpu);
+    }
+
+    for (std::size_t i = 0; true; i++)
+    {
+      std::size_t size = res.cpus.size();
+      for (auto& cpus : nodes)
+        if (i < cpus.size())
+          res.cpus.push_back(cpus[i]);
+      if (res.cpus.size() == size)
+        break;
+    }
+
+    return res;
+  }();
+
+  return pinCpus;
+}
+
+#endif
+
+} // namespace
+
+namespace primesieve {
+
+ThreadPool& ThreadPool::get()
+{
+  static ThreadPool threadPool;
+  return threadPool;
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    isExit_ = true;
+  }
+
+  work_.notify_all();
+
+  for (auto& thread : threads_)
+    thread.join();
+}
+
+/// Create new worker threads until there are
+/// at least threads worker threads.
+///
+void ThreadPool::addThreads(int threads)
+{
+  while ((int) threads_.size() < threads)
+  {
+    threads_.emplace_back(&ThreadPool::worker, this);
+    if (isPinThreads_)
+      setAffinity(threads_.size() - 1);
+  }
+}
+
+/// Pin each worker thread to a CPU core, the worker threads
+/// are spread evenly across the NUMA nodes. Each task of
+/// ParallelSieve allocates and initializes its memory (sieve
+/// array, buckets, pre-sieving buffers) in the thread that
+/// runs it, hence with the operating system's default
+/// first-touch policy the memory of a task run by a pinned
+/// worker thread is located on that worker's NUMA node.
+/// This does not apply to the tasks run by the (unpinned)
+/// thread calling run() and to the shared read-only sieving
+/// primes table, which is located on a single NUMA node.
+///
+void ThreadPool::setPinThreads(bool pin)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  if (pin != isPinThreads_)
+  {
+    isPinThreads_ = pin;
+    for (std::size_t i = 0; i < threads_.size(); i++)
+      setAffinity(i);
+  }
+}
+
+/// Pin the ith worker thread or restore the
+/// default affinity if pinning is disabled.
+///
+void ThreadPool::setAffinity(std::size_t i)
+{
+#if defined(HAS_PTHREAD_AFFINITY)
+  const PinCpus& pinCpus = getPinCpus();
+  if (pinCpus.cpus.empty())
+    return;
+
+  cpu_set_t cpus = pinCpus.allowed;
+
+  // The 1st CPU is left to the thread calling run()
+  if (isPinThreads_)
+  {
+    CPU_ZERO(&cpus);
+    CPU_SET(pinCpus.cpus[(i + 1) % pinCpus.cpus.size()], &cpus);
+  }
+
+  pthread_setaffinity_np(threads_[i].native_handle(), sizeof(cpus), &cpus);
+#else
+  (void) i;
+#endif
+}
+
+/// Runs task(0), task(1), ..., task(tasks - 1) in parallel
+/// and waits until all tasks have finished. If a task
+/// throws an exception it is rethrown by run().
+///
+void ThreadPool::run(int tasks, const std::function<void(int)>& task)
+{
+  if (tasks <= 1)
+  {
+    if (tasks == 1)
+      task(0);
+    return;
+  }
+
+  Job job;
+  job.task = &task;
+  job.tasks = tasks;
+  job.next = 0;
+  job.finished = 0;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  // The calling thread executes tasks as well
+  int maxThreads = ParallelSieve::getMaxThreads() - 1;
+  addThreads(std::min(tasks - 1, maxThreads));
+  jobs_.push_back(&job);
+  work_.notify_all();
+
+  while (job.next < job.tasks)
+    runTask(job, lock);
+
+  done_.wait(lock, [&] { return job.finished == job.tasks; });
+
+  if (job.error)
+    std::rethrow_exception(job.error);
+}
+
+/// Execute the next task of the job.
+/// @pre lock is locked and job.next < job.tasks.
+///
+void ThreadPool::runTask(Job& job, std::unique_lock<std::mutex>& lock)
+{
+  ASSERT(job.next < job.tasks);
+  int i = job.next++;
+
+  // All tasks of the job have been started
+  if (job.next == job.tasks)
+  {
+    auto iter = std::find(jobs_.begin(), jobs_.end(), &job);
+    ASSERT(iter != jobs_.end());
+    std::copy(iter + 1, jobs_.end(), iter);
+    jobs_.resize(jobs_.size() - 1);
+  }
+
+  lock.unlock();
+
+  std::exception_ptr error;
+
+  try
+  {
+    (*job.task)(i);
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+
+  lock.lock();
+
+  if (error && !job.error)
+    job.error = error;
+
+  job.finished++;
+
+  if (job.finished == job.tasks)
+    done_.notify_all();
+}
+
+void ThreadPool::worker()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true)
+  {
+    work_.wait(lock, [&] { return isExit_ || !jobs_.empty(); });
+
+    if (isExit_)
+      return;
+
+    runTask(*jobs_.front(), lock);
+  }
+}
+
+} // namespace
@@ -322,6 +322,29 @@ void primesieve_set_num_threads(int num_threads)
   set_num_threads(num_threads);
 }
 
+void primesieve_set_pin_threads(int pin)
+{
+  set_pin_threads(pin != 0);
+}
+
+void primesieve_set_huge_pages(int enable)
+{
+  set_huge_pages(enable != 0);
+}
+
+void primesieve_set_pi_index(const char* filename)
+{
+  try
+  {
+    set_pi_index(filename ? filename : "");
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "primesieve_set_pi_index: " << e.what() << std::endl;
+    errno = EDOM;
+  }
+}
+
 uint64_t primesieve_get_max_stop(void)
 {
   return get_max_stop();
@@ -13,14 +13,20 @@
 #include <primesieve.hpp>
 #include <primesieve/config.hpp>
 #include <primesieve/CpuInfo.hpp>
+#include <primesieve/HugePages.hpp>
 #include <primesieve/pmath.hpp>
+#include <primesieve/PrimePiIndex.hpp>
 #include <primesieve/PrimeSieve.hpp>
 #include <primesieve/ParallelSieve.hpp>
+#include <primesieve/ThreadPool.hpp>
 
 #include <stdint.h>
 #include <cstddef>
+#include <functional>
 #include <limits>
 #include <string>
+#include <utility>
+#include <vector>
 
 using std::size_t;
 
@@ -30,6 +36,9 @@ int sieve_size = 0;
 
 int num_threads = 0;
 
+/// Used by count_primes() if set_pi_index() has been called
+primesieve::PrimePiIndex pi_index;
+
 }
 
 namespace primesieve {
@@ -37,11 +46,85 @@ namespace primesieve {
 uint64_t nth_prime(int64_t n, uint64_t start)
 {
   ParallelSieve ps;
+  if (!pi_index.empty())
+    ps.setPiIndex(&pi_index);
   return ps.nthPrime(n, start);
 }
 
+std::vector<uint64_t> nth_primes(const std::vector<int64_t>& n, uint64_t start)
+{
+  std::vector<uint64_t> primes(n.size());
+  ParallelSieve ps;
+  if (!pi_index.empty())
+    ps.setPiIndex(&pi_index);
+  ps.nthPrimes(n.data(), n.size(), start, primes.data());
+  return primes;
+}
+
+size_t store_primes_parallel_size(uint64_t start,
+                                  uint64_t stop,
+                                  int threads)
+{
+  ParallelSieve ps;
+  ps.setNumThreads(threads);
+  ps.setStart(start);
+  ps.setStop(stop);
+  return ps.storePrimesSize();
+}
+
+size_t store_primes_parallel(uint64_t start,
+                             uint64_t stop,
+                             int threads,
+                             void* primes,
+                             size_t size,
+                             size_t typeSize)
+{
+  ParallelSieve ps;
+  ps.setNumThreads(threads);
+  ps.setStart(start);
+  ps.setStop(stop);
+  return ps.storePrimes(primes, size, typeSize);
+}
+
+void parallel_for_each_prime_block(uint64_t start,
+                                   uint64_t stop,
+                                   const std::function<void(const uint64_t*, size_t, int)>& callback)
+{
+  ParallelSieve ps;
+  ps.setStart(start);
+  ps.setStop(stop);
+  ps.forEachPrimeBlock(callback);
+}
+
+void for_each_segment(uint64_t start,
+                      uint64_t stop,
+                      const std::function<void(const uint8_t*, size_t, uint64_t)>& callback)
+{
+  ParallelSieve ps;
+  ps.setNumThreads(1);
+  ps.setStart(start);
+  ps.setStop(stop);
+  ps.forEachSegment([&](const uint8_t* sieve, size_t size, uint64_t low, int)
+  {
+    callback(sieve, size, low);
+  });
+}
+
+void parallel_for_each_segment(uint64_t start,
+                               uint64_t stop,
+                               const std::function<void(const uint8_t*, size_t, uint64_t, int)>& callback)
+{
+  ParallelSieve ps;
+  ps.setStart(start);
+  ps.setStop(stop);
+  ps.forEachSegment(callback);
+}
+
 uint64_t count_primes(uint64_t start, uint64_t stop)
 {
+  if (pi_index.isUseful(start, stop))
+    return pi_index.countPrimes(start, stop);
+
   ParallelSieve ps;
   ps.sieve(start, stop, COUNT_PRIMES);
   return ps.getCount(0);
@@ -82,39 +165,97 @@ uint64_t count_sextuplets(uint64_t start, uint64_t stop)
   return ps.getCount(5);
 }
 
+std::vector<uint64_t> count_primes_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals)
+{
+  std::vector<uint64_t> counts(intervals.size());
+  ParallelSieve ps;
+  ps.countBatch(intervals.data(), intervals.size(), 0, counts.data());
+  return counts;
+}
+
+std::vector<uint64_t> count_twins_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals)
+{
+  std::vector<uint64_t> counts(intervals.size());
+  ParallelSieve ps;
+  ps.countBatch(intervals.data(), intervals.size(), 1, counts.data());
+  return counts;
+}
+
+std::vector<uint64_t> count_triplets_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals)
+{
+  std::vector<uint64_t> counts(intervals.size());
+  ParallelSieve ps;
+  ps.countBatch(intervals.data(), intervals.size(), 2, counts.data());
+  return counts;
+}
+
+std::vector<uint64_t> count_quadruplets_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals)
+{
+  std::vector<uint64_t> counts(intervals.size());
+  ParallelSieve ps;
+  ps.countBatch(intervals.data(), intervals.size(), 3, counts.data());
+  return counts;
+}
+
+std::vector<uint64_t> count_quintuplets_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals)
+{
+  std::vector<uint64_t> counts(intervals.size());
+  ParallelSieve ps;
+  ps.countBatch(intervals.data(), intervals.size(), 4, counts.data());
+  return counts;
+}
+
+std::vector<uint64_t> count_sextuplets_batch(const std::vector<std::pair<uint64_t, uint64_t>>& intervals)
+{
+  std::vector<uint64_t> counts(intervals.size());
+  ParallelSieve ps;
+  ps.countBatch(intervals.data(), intervals.size(), 5, counts.data());
+  return counts;
+}
+
+std::pair<uint64_t, uint64_t> get_shard(uint64_t start, uint64_t stop, uint64_t i, uint64_t n)
+{
+  ParallelSieve ps;
+  ps.setStart(start);
+  ps.setStop(stop);
+  std::pair<uint64_t, uint64_t> shard;
+  ps.getShard(i, n, shard.first, shard.second);
+  return shard;
+}
+
 void print_primes(uint64_t start, uint64_t stop)
 {
-  PrimeSieve ps;
+  ParallelSieve ps;
   ps.sieve(start, stop, PRINT_PRIMES);
 }
 
 void print_twins(uint64_t start, uint64_t stop)
 {
-  PrimeSieve ps;
+  ParallelSieve ps;
   ps.sieve(start, stop, PRINT_TWINS);
 }
 
 void print_triplets(uint64_t start, uint64_t stop)
 {
-  PrimeSieve ps;
+  ParallelSieve ps;
   ps.sieve(start, stop, PRINT_TRIPLETS);
 }
 
 void print_quadruplets(uint64_t start, uint64_t stop)
 {
-  PrimeSieve ps;
+  ParallelSieve ps;
   ps.sieve(start, stop, PRINT_QUADRUPLETS);
 }
 
 void print_quintuplets(uint64_t start, uint64_t stop)
 {
-  PrimeSieve ps;
+  ParallelSieve ps;
   ps.sieve(start, stop, PRINT_QUINTUPLETS);
 }
 
 void print_sextuplets(uint64_t start, uint64_t stop)
 {
-  PrimeSieve ps;
+  ParallelSieve ps;
   ps.sieve(start, stop, PRINT_SEXTUPLETS);
 }
 
@@ -131,6 +272,24 @@ void set_num_threads(int threads)
   num_threads = inBetween(1, threads, ParallelSieve::getMaxThreads());
 }
 
+void set_pin_threads(bool pin)
+{
+  ThreadPool::get().setPinThreads(pin);
+}
+
+void set_huge_pages(bool enable)
+{
+  setHugePages(enable);
+}
+
+void set_pi_index(const std::string& filename)
+{
+  if (filename.empty())
+    pi_index.clear();
+  else
+    pi_index.load(filename);
+}
+
 uint64_t get_max_stop()
 {
   return std::numeric_limits<uint64_t>::max();
@@ -27,6 +27,7 @@
 
 #include <cstddef>
 #include <cctype>
+#include <exception>
 #include <map>
 #include <stdint.h>
 #include <string>
@@ -220,6 +221,12 @@ void CmdOptions::optionPrint(Option& opt)
   }
 }
 
+void CmdOptions::optionBuildPiIndex(Option& opt)
+{
+  setMainOption(OPTION_BUILD_INDEX, opt.str);
+  piIndexFile = opt.val;
+}
+
 void CmdOptions::optionCount(Option& opt)
 {
   // by default count primes
@@ -254,6 +261,46 @@ void CmdOptions::optionDistance(Option& opt)
   numbers.push_back(start + val);
 }
 
+/// Threshold factor between EratSmall, EratMedium
+/// and EratBig, see EratTuning.hpp
+///
+double CmdOptions::optionEratFactor(Option& opt)
+{
+  try
+  {
+    std::size_t pos = 0;
+    double factor = std::stod(opt.val, &pos);
+    if (pos == opt.val.size() &&
+        factor > 0 &&
+        factor <= 4.5)
+      return factor;
+  }
+  catch (std::exception&)
+  { }
+
+  throw primesieve_error("invalid option '" + opt.opt + "=" + opt.val + "', FACTOR must be > 0 and <= 4.5");
+}
+
+/// Output format for printing primes
+void CmdOptions::optionFormat(Option& opt)
+{
+  std::transform(opt.val.begin(), opt.val.end(), opt.val.begin(),
+                 [](unsigned char c){ return std::tolower(c); });
+
+  if (opt.val == "text")
+    return;
+  else if (opt.val == "u32")
+    flags |= PRINT_UINT32;
+  else if (opt.val == "u64")
+    flags |= PRINT_UINT64;
+  else if (opt.val == "varint")
+    flags |= PRINT_VARINT;
+  else if (opt.val == "bitmap")
+    flags |= PRINT_BITMAP;
+  else
+    throw primesieve_error("invalid option '" + opt.opt + "=" + opt.val + "'");
+}
+
 void CmdOptions::optionStressTest(Option& opt)
 {
   setMainOption(OPTION_STRESS_TEST, opt.str);
@@ -273,6 +320,24 @@ void CmdOptions::optionStressTest(Option& opt)
 }
 
 /// Stress test timeout
+/// --shard=i/N, sieve the ith of N shards
+void CmdOptions::optionShard(Option& opt)
+{
+  std::size_t pos = opt.val.find('/');
+  if (pos == std::string::npos)
+    throw primesieve_error("invalid option '" + opt.opt + "=" + opt.val + "', expected i/N");
+
+  Option index = opt;
+  Option count = opt;
+  index.val = opt.val.substr(0, pos);
+  count.val = opt.val.substr(pos + 1);
+  shard = index.getValue<uint64_t>();
+  shards = count.getValue<uint64_t>();
+
+  if (shard < 1 || shard > shards)
+    throw primesieve_error("invalid option '" + opt.opt + "=" + opt.val + "', requires 1 <= i <= N");
+}
+
 void CmdOptions::optionTimeout(Option& opt)
 {
   std::transform(opt.val.begin(), opt.val.end(), opt.val.begin(),
@@ -302,11 +367,15 @@ CmdOptions parseOptions(int argc, char* argv[])
   /// primesieve command-line options
   const std::map<std::string, std::pair<OptionID, IsParam>> optionMap =
   {
+    { "--build-pi-index",   std::make_pair(OPTION_BUILD_INDEX, REQUIRED_PARAM) },
+    { "--checkpoint",       std::make_pair(OPTION_CHECKPOINT, REQUIRED_PARAM) },
     { "-c",                 std::make_pair(OPTION_COUNT, OPTIONAL_PARAM) },
     { "--count",            std::make_pair(OPTION_COUNT, OPTIONAL_PARAM) },
     { "--cpu-info",         std::make_pair(OPTION_CPU_INFO, NO_PARAM) },
     { "-h",                 std::make_pair(OPTION_HELP, NO_PARAM) },
     { "--help",             std::make_pair(OPTION_HELP, NO_PARAM) },
+    { "--merge",            std::make_pair(OPTION_MERGE, NO_PARAM) },
+    { "--huge-pages",       std::make_pair(OPTION_HUGE_PAGES, NO_PARAM) },
     { "-n",                 std::make_pair(OPTION_NTH_PRIME, NO_PARAM) },
     { "--nthprime",         std::make_pair(OPTION_NTH_PRIME, NO_PARAM) },
     { "--nth-prime",        std::make_pair(OPTION_NTH_PRIME, NO_PARAM) },
@@ -314,6 +383,12 @@ CmdOptions parseOptions(int argc, char* argv[])
     { "--number",           std::make_pair(OPTION_NUMBER, REQUIRED_PARAM) },
     { "-d",                 std::make_pair(OPTION_DISTANCE, REQUIRED_PARAM) },
     { "--dist",             std::make_pair(OPTION_DISTANCE, REQUIRED_PARAM) },
+    { "--erat-medium",      std::make_pair(OPTION_ERAT_MEDIUM, REQUIRED_PARAM) },
+    { "--erat-small",       std::make_pair(OPTION_ERAT_SMALL, REQUIRED_PARAM) },
+    { "--format",           std::make_pair(OPTION_FORMAT, REQUIRED_PARAM) },
+    { "--pi-index",         std::make_pair(OPTION_PI_INDEX, REQUIRED_PARAM) },
+    { "--pi-index-stride",  std::make_pair(OPTION_PI_STRIDE, REQUIRED_PARAM) },
+    { "--pin-threads",      std::make_pair(OPTION_PIN_THREADS, NO_PARAM) },
     { "-p",                 std::make_pair(OPTION_PRINT, OPTIONAL_PARAM) },
     { "--print",            std::make_pair(OPTION_PRINT, OPTIONAL_PARAM) },
     { "-q",                 std::make_pair(OPTION_QUIET, NO_PARAM) },
@@ -321,8 +396,11 @@ CmdOptions parseOptions(int argc, char* argv[])
     { "-R",                 std::make_pair(OPTION_R, NO_PARAM) },
     { "--RiemannR",         std::make_pair(OPTION_R, NO_PARAM) },
     { "--RiemannR-inverse", std::make_pair(OPTION_R_INVERSE, NO_PARAM) },
+    { "--resume",           std::make_pair(OPTION_RESUME, NO_PARAM) },
+    { "--result",           std::make_pair(OPTION_RESULT, REQUIRED_PARAM) },
     { "-s",                 std::make_pair(OPTION_SIZE, REQUIRED_PARAM) },
     { "--size",             std::make_pair(OPTION_SIZE, REQUIRED_PARAM) },
+    { "--shard",            std::make_pair(OPTION_SHARD, REQUIRED_PARAM) },
     { "-S",                 std::make_pair(OPTION_STRESS_TEST, OPTIONAL_PARAM) },
     { "--stress-test",      std::make_pair(OPTION_STRESS_TEST, OPTIONAL_PARAM) },
     { "--test",             std::make_pair(OPTION_TEST, NO_PARAM) },
@@ -338,19 +416,39 @@ CmdOptions parseOptions(int argc, char* argv[])
 
   for (int i = 1; i < argc; i++)
   {
+    // primesieve --merge FILE...
+    if (opts.option == OPTION_MERGE &&
+        !isOption(argv[i]))
+    {
+      opts.mergeFiles.push_back(argv[i]);
+      continue;
+    }
+
     Option opt = parseOption(argc, argv, i, optionMap);
     OptionID optionID = optionMap.at(opt.opt).first;
 
     switch (optionID)
     {
+      case OPTION_BUILD_INDEX: opts.optionBuildPiIndex(opt); break;
+      case OPTION_CHECKPOINT:  opts.checkpointFile = opt.val; break;
       case OPTION_COUNT:       opts.optionCount(opt); break;
       case OPTION_DISTANCE:    opts.optionDistance(opt); break;
+      case OPTION_ERAT_MEDIUM: opts.factorEratMedium = opts.optionEratFactor(opt); break;
+      case OPTION_ERAT_SMALL:  opts.factorEratSmall = opts.optionEratFactor(opt); break;
+      case OPTION_FORMAT:      opts.optionFormat(opt); break;
+      case OPTION_PI_INDEX:    opts.piIndexFile = opt.val; break;
+      case OPTION_PI_STRIDE:   opts.piIndexStride = opt.getValue<uint64_t>(); break;
       case OPTION_PRINT:       opts.optionPrint(opt); break;
+      case OPTION_RESULT:      opts.resultFile = opt.val; break;
+      case OPTION_SHARD:       opts.optionShard(opt); break;
       case OPTION_STRESS_TEST: opts.optionStressTest(opt); break;
       case OPTION_TIMEOUT:     opts.optionTimeout(opt); break;
       case OPTION_SIZE:        opts.sieveSize = opt.getValue<int>(); break;
       case OPTION_THREADS:     opts.threads = opt.getValue<int>(); break;
+      case OPTION_HUGE_PAGES:  opts.hugePages = true; break;
+      case OPTION_PIN_THREADS: opts.pinThreads = true; break;
       case OPTION_QUIET:       opts.quiet = true; break;
+      case OPTION_RESUME:      opts.resume = true; break;
       case OPTION_NO_STATUS:   opts.status = false; break;
       case OPTION_TIME:        opts.time = true; break;
       case OPTION_NUMBER:      opts.numbers.push_back(opt.getValue<uint64_t>()); break;
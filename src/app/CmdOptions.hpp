@@ -20,17 +20,30 @@
 
 enum OptionID
 {
+  OPTION_BUILD_INDEX,
+  OPTION_CHECKPOINT,
   OPTION_COUNT,
   OPTION_CPU_INFO,
   OPTION_HELP,
+  OPTION_HUGE_PAGES,
+  OPTION_MERGE,
   OPTION_NTH_PRIME,
   OPTION_NO_STATUS,
+  OPTION_PI_INDEX,
+  OPTION_PI_STRIDE,
+  OPTION_PIN_THREADS,
   OPTION_NUMBER,
   OPTION_DISTANCE,
+  OPTION_ERAT_MEDIUM,
+  OPTION_ERAT_SMALL,
+  OPTION_FORMAT,
   OPTION_PRINT,
   OPTION_QUIET,
   OPTION_R,
   OPTION_R_INVERSE,
+  OPTION_RESUME,
+  OPTION_RESULT,
+  OPTION_SHARD,
   OPTION_SIZE,
   OPTION_STRESS_TEST,
   OPTION_TEST,
@@ -67,22 +80,41 @@ struct CmdOptions
 {
   primesieve::Vector<uint64_t> numbers;
   std::string stressTestMode;
+  std::string checkpointFile;
+  std::string piIndexFile;
+  std::string resultFile;
+  primesieve::Vector<std::string> mergeFiles;
   std::string optionStr;
   int option = -1;
   int flags = 0;
   int sieveSize = 0;
   int threads = 0;
+  // 0 = use the default stride
+  uint64_t piIndexStride = 0;
+  // Sieve the ith of N shards, 1 <= i <= N
+  uint64_t shard = 0;
+  uint64_t shards = 0;
+  // 0 = use default EratSmall/EratMedium thresholds
+  double factorEratSmall = 0;
+  double factorEratMedium = 0;
   // Stress test timeout in seconds.
   // The default timeout is 24 hours (same as stress-ng).
   int64_t timeout = 24 * 3600;
+  bool hugePages = false;
+  bool pinThreads = false;
   bool quiet = false;
+  bool resume = false;
   bool status = true;
   bool time = false;
 
   void setMainOption(OptionID optionID, const std::string& optStr);
   void optionPrint(Option& opt);
+  void optionBuildPiIndex(Option& opt);
   void optionCount(Option& opt);
   void optionDistance(Option& opt);
+  double optionEratFactor(Option& opt);
+  void optionFormat(Option& opt);
+  void optionShard(Option& opt);
   void optionStressTest(Option& opt);
   void optionTimeout(Option& opt);
 };
@@ -23,17 +23,39 @@ void help(int exitCode)
     "(< 2^64) using the segmented sieve of Eratosthenes.\n"
     "\n"
     "Options:\n"
+    "      --build-pi-index=FILE  Build a prime count index of PrimePi(i * STRIDE)\n"
+    "                             for all i * STRIDE <= STOP, see --pi-index.\n"
+    "      --checkpoint=FILE      Periodically save the progress of --count to\n"
+    "                             FILE, see --resume.\n"
     "  -c, --count[=NUM+]         Count primes and/or prime k-tuplets, NUM <= 6.\n"
     "                             Count primes: -c or --count (default option),\n"
     "                             count twin primes: -c2 or --count=2,\n"
     "                             count prime triplets: -c3 or --count=3, ...\n"
     "      --cpu-info             Print CPU information (cache sizes).\n"
     "  -d, --dist=DIST            Sieve the interval [START, START + DIST].\n"
+    "      --erat-medium=FACTOR   Sieving primes <= sieve size * FACTOR are\n"
+    "                             processed by EratMedium, FACTOR <= 4.5.\n"
+    "      --erat-small=FACTOR    Sieving primes <= L1 cache size * FACTOR are\n"
+    "                             processed by EratSmall, FACTOR <= 4.5. The\n"
+    "                             factors in use are shown by --cpu-info.\n"
+    "      --format=FORMAT        Output format for --print: text (default),\n"
+    "                             u32, u64 (little-endian binary), varint (LEB128\n"
+    "                             of the difference to the previous prime) or\n"
+    "                             bitmap (raw sieve array, primes >= 7 only).\n"
     "  -h, --help                 Print this help menu.\n"
+    "      --huge-pages           Allocate the sieve arrays using 2 MiB huge\n"
+    "                             pages, reduces TLB misses (Linux only).\n"
     "  -n, --nth-prime            Find the nth prime.\n"
     "                             primesieve 100 -n: finds the 100th prime,\n"
     "                             primesieve 2 100 -n: finds the 2nd prime > 100.\n"
+    "      --merge FILE...        Add up the --result files of all shards.\n"
     "      --no-status            Turn off the progressing status.\n"
+    "      --pi-index=FILE        Count primes using a prime count index, only\n"
+    "                             the numbers near START and STOP are sieved.\n"
+    "                             Also speeds up finding the nth prime (-n).\n"
+    "      --pi-index-stride=N    Distance between the index entries (2^32).\n"
+    "      --pin-threads          Pin the threads to CPU cores, spread evenly\n"
+    "                             across the NUMA nodes (Linux only).\n"
     "  -p, --print[=NUM]          Print primes or prime k-tuplets, NUM <= 6.\n"
     "                             Print primes: -p or --print,\n"
     "                             print twin primes: -p2 or --print=2,\n"
@@ -43,15 +65,21 @@ void help(int exitCode)
     "                             approximation of PrimePi(x).\n"
     "      --RiemannR-inverse     Inverse Riemann R function, very accurate\n"
     "                             approximation of the nth prime.\n"
+    "      --result=FILE          Save the counts to FILE, see --merge.\n"
+    "      --resume               Resume an interrupted computation from its\n"
+    "                             --checkpoint=FILE.\n"
     "  -s, --size=SIZE            Set the sieve size in KiB, SIZE <= 8192.\n"
     "                             By default primesieve uses a sieve size that\n"
     "                             matches your CPU's L1 cache size (per core) or is\n"
     "                             slightly smaller than your CPU's L2 cache size.\n"
+    "      --shard=i/N            Split [START, STOP] into N shards and only\n"
+    "                             count the ith shard, 1 <= i <= N.\n"
     "  -S, --stress-test[=MODE]   Run a stress test. The MODE can be either\n"
     "                             CPU (default) or RAM. The default timeout is 24h.\n"
     "      --test                 Run various correctness tests (< 1 minute).\n"
     "  -t, --threads=NUM          Set the number of threads, NUM <= CPU cores.\n"
-    "                             Default setting: use all available CPU cores.\n"
+    "                             Default setting: use all available CPU cores\n"
+    "                             (respects CPU affinity and cgroup CPU quota).\n"
     "      --time                 Print the time elapsed in seconds.\n"
     "      --timeout=SEC          Set the stress test timeout in seconds. Supported\n"
     "                             units of time suffixes: s, m, h, d or y.\n"
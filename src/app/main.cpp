@@ -21,32 +21,65 @@
 /// file in the top level directory.
 ///
 
+#include <primesieve/Checkpoint.hpp>
+#include <primesieve/config.hpp>
 #include <primesieve/CpuInfo.hpp>
+#include <primesieve/EratTuning.hpp>
+#include <primesieve/HugePages.hpp>
 #include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PrimePiIndex.hpp>
 #include <primesieve/primesieve_error.hpp>
 #include <primesieve/RiemannR.hpp>
+#include <primesieve/ThreadPool.hpp>
 #include <primesieve/Vector.hpp>
 #include "CmdOptions.hpp"
 
 #include <stdint.h>
+#include <algorithm>
+#include <chrono>
 #include <exception>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 
+#if defined(_WIN32)
+  #include <fcntl.h>
+  #include <io.h>
+  #include <stdio.h>
+#endif
+
 void help(int exitCode);
 void version();
 void stressTest(const CmdOptions& opts);
 void test();
 
 using primesieve::Array;
+using primesieve::Checkpoint;
 using primesieve::ParallelSieve;
+using primesieve::PrimePiIndex;
 using primesieve::primesieve_error;
 using primesieve::PRINT_STATUS;
+using primesieve::PRINT_UINT32;
+using primesieve::PRINT_BITMAP;
 
 namespace {
 
+/// Labels of the counts, used for the
+/// output and for the --result files.
+const Array<std::string, 6> countLabels =
+{
+  "Primes",
+  "Twin primes",
+  "Prime triplets",
+  "Prime quadruplets",
+  "Prime quintuplets",
+  "Prime sextuplets"
+};
+
 void printSettings(const ParallelSieve& ps)
 {
   std::cout << "Sieve size = " << ps.getSieveSize() << " KiB" << std::endl;
@@ -58,6 +91,294 @@ void printSeconds(double sec)
   std::cout << "Seconds: " << std::fixed << std::setprecision(3) << sec << std::endl;
 }
 
+/// The binary output formats must not
+/// convert '\n' to "\r\n" on Windows.
+///
+void setBinaryStdout()
+{
+#if defined(_WIN32)
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+}
+
+/// Override the default thresholds between
+/// EratSmall, EratMedium and EratBig
+///
+void setEratTuning(const CmdOptions& opts)
+{
+  if (opts.factorEratSmall > 0 ||
+      opts.factorEratMedium > 0)
+  {
+    const auto& tuning = primesieve::getEratTuning();
+    double factorEratSmall = tuning.factorEratSmall;
+    double factorEratMedium = tuning.factorEratMedium;
+
+    if (opts.factorEratSmall > 0)
+      factorEratSmall = opts.factorEratSmall;
+    if (opts.factorEratMedium > 0)
+      factorEratMedium = opts.factorEratMedium;
+
+    primesieve::setEratTuning(factorEratSmall, factorEratMedium);
+  }
+}
+
+/// Count the primes inside [start, stop] using the prime
+/// count index file. Returns false if using the index is
+/// slower than sieving [start, stop].
+///
+bool countPrimesPiIndex(const CmdOptions& opts, ParallelSieve& ps)
+{
+  if (!ps.isCountPrimes() ||
+      ps.isCountkTuplets() ||
+      ps.isPrint())
+    throw primesieve_error("option --pi-index requires --count (primes only)");
+
+  PrimePiIndex index;
+  index.load(opts.piIndexFile);
+
+  if (!index.isUseful(ps.getStart(), ps.getStop()))
+    return false;
+
+  if (opts.threads)
+    index.setNumThreads(opts.threads);
+
+  if (!opts.quiet)
+  {
+    printSettings(ps);
+    std::cout << "Pi index stop = " << index.getStop() << std::endl;
+  }
+
+  auto t1 = std::chrono::system_clock::now();
+  uint64_t count = index.countPrimes(ps.getStart(), ps.getStop());
+  auto t2 = std::chrono::system_clock::now();
+  std::chrono::duration<double> seconds = t2 - t1;
+
+  if (opts.time)
+    printSeconds(seconds.count());
+
+  if (opts.quiet)
+    std::cout << count << std::endl;
+  else
+    std::cout << "Primes: " << count << std::endl;
+
+  return true;
+}
+
+/// Build (or extend) the prime count index file. The index is
+/// saved after each 1% of progress, hence an interrupted
+/// computation is resumed by running the same command again.
+///
+void buildPiIndex(const CmdOptions& opts)
+{
+  if (opts.numbers.empty())
+    throw primesieve_error("missing STOP number");
+  if (opts.numbers.size() > 1)
+    throw primesieve_error("option --build-pi-index does not support a START number");
+
+  uint64_t stop = opts.numbers[0];
+  uint64_t stride = opts.piIndexStride;
+  PrimePiIndex index;
+
+  if (std::ifstream(opts.piIndexFile).good())
+  {
+    index.load(opts.piIndexFile);
+    if (stride == 0)
+      stride = index.getStride();
+    else if (stride != index.getStride())
+      throw primesieve_error("existing pi index uses stride " + std::to_string(index.getStride()));
+  }
+
+  if (stride == 0)
+    stride = config::PI_INDEX_STRIDE;
+  if (opts.threads)
+    index.setNumThreads(opts.threads);
+
+  if (!opts.quiet)
+    std::cout << "Pi index stride = " << stride << std::endl;
+
+  auto t1 = std::chrono::system_clock::now();
+  index.build(index.getStop(), stride);
+  uint64_t last = stop - stop % stride;
+  uint64_t step = std::max<uint64_t>(1, last / stride / 100) * stride;
+  int percent = -1;
+
+  while (true)
+  {
+    uint64_t low = index.getStop();
+    if (low < last)
+      index.build(low + std::min(step, last - low), stride);
+
+    index.save(opts.piIndexFile);
+
+    if (opts.status)
+    {
+      int old = percent;
+      percent = (last > 0) ? (int) (index.getStop() * 100.0 / last) : 100;
+      if (percent > old)
+        std::cout << '\r' << percent << '%' << std::flush;
+      if (percent == 100)
+        std::cout << '\n';
+    }
+
+    if (index.getStop() >= last)
+      break;
+  }
+
+  auto t2 = std::chrono::system_clock::now();
+  std::chrono::duration<double> seconds = t2 - t1;
+
+  if (opts.time)
+    printSeconds(seconds.count());
+
+  if (!opts.quiet)
+    std::cout << "Pi index stop: " << index.getStop() << std::endl;
+}
+
+/// Save the counts of primesieve START STOP --shard=i/N
+/// to a small text file. The result files of the N shards
+/// are added up using primesieve --merge FILE...
+///
+void saveResult(const CmdOptions& opts,
+                uint64_t start,
+                uint64_t stop,
+                const ParallelSieve& ps)
+{
+  std::ofstream file(opts.resultFile);
+  uint64_t shard = std::max(opts.shard, (uint64_t) 1);
+  uint64_t shards = std::max(opts.shards, (uint64_t) 1);
+
+  file << "Start: " << start << "\n";
+  file << "Stop: " << stop << "\n";
+  file << "Shard: " << shard << "/" << shards << "\n";
+
+  for (int i = 0; i < 6; i++)
+    if (ps.isCount(i))
+      file << countLabels[i] << ": " << ps.getCount(i) << "\n";
+
+  file.close();
+
+  if (!file)
+    throw primesieve_error("failed to write result file: " + opts.resultFile);
+}
+
+uint64_t parseUint64(const std::string& str, const std::string& filename)
+{
+  try
+  {
+    std::size_t pos = 0;
+    uint64_t n = std::stoull(str, &pos);
+    if (pos == str.size())
+      return n;
+  }
+  catch (std::exception&)
+  { }
+
+  throw primesieve_error("invalid result file: " + filename);
+}
+
+/// primesieve --merge FILE...
+/// Add up the counts of the result files of
+/// primesieve START STOP --shard=i/N --result=FILE.
+/// All N shards must be present exactly once.
+///
+void merge(const CmdOptions& opts)
+{
+  if (opts.mergeFiles.empty())
+    throw primesieve_error("missing result files for option --merge");
+
+  uint64_t start = 0;
+  uint64_t stop = 0;
+  uint64_t shards = 0;
+  std::string labels;
+  primesieve::Vector<char> isMerged;
+  primesieve::counts_t counts;
+  counts.fill(0);
+
+  for (const std::string& filename : opts.mergeFiles)
+  {
+    std::ifstream file(filename);
+    if (!file)
+      throw primesieve_error("failed to open result file: " + filename);
+
+    std::map<std::string, std::string> values;
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+      std::size_t pos = line.find(": ");
+      if (pos == std::string::npos)
+        throw primesieve_error("invalid result file: " + filename);
+      values[line.substr(0, pos)] = line.substr(pos + 2);
+    }
+
+    std::string shard = values["Shard"];
+    std::size_t pos = shard.find('/');
+    if (pos == std::string::npos)
+      throw primesieve_error("invalid result file: " + filename);
+
+    uint64_t i = parseUint64(shard.substr(0, pos), filename);
+    uint64_t n = parseUint64(shard.substr(pos + 1), filename);
+    uint64_t low = parseUint64(values["Start"], filename);
+    uint64_t high = parseUint64(values["Stop"], filename);
+
+    // Count labels of this file
+    std::string fileLabels;
+    for (int j = 0; j < 6; j++)
+      fileLabels += values.count(countLabels[j]) ? '1' : '0';
+
+    if (i < 1 || i > n)
+      throw primesieve_error("invalid result file: " + filename);
+
+    if (isMerged.empty())
+    {
+      start = low;
+      stop = high;
+      shards = n;
+      labels = fileLabels;
+      isMerged.resize(n);
+      std::fill(isMerged.begin(), isMerged.end(), 0);
+    }
+    else if (low != start ||
+             high != stop ||
+             n != shards ||
+             fileLabels != labels)
+      throw primesieve_error("result file " + filename + " belongs to a different computation");
+
+    if (isMerged[i - 1])
+      throw primesieve_error("duplicate shard " + shard + ": " + filename);
+
+    isMerged[i - 1] = 1;
+
+    for (int j = 0; j < 6; j++)
+      if (labels[j] == '1')
+        counts[j] += parseUint64(values[countLabels[j]], filename);
+  }
+
+  for (uint64_t i = 0; i < shards; i++)
+    if (!isMerged[i])
+      throw primesieve_error("missing shard " + std::to_string(i + 1) + "/" + std::to_string(shards));
+
+  if (!opts.quiet)
+  {
+    std::cout << "Start = " << start << std::endl;
+    std::cout << "Stop = " << stop << std::endl;
+    std::cout << "Shards = " << shards << std::endl;
+  }
+
+  int cnt = (int) std::count(labels.begin(), labels.end(), '1');
+
+  for (int j = 0; j < 6; j++)
+  {
+    if (labels[j] == '1')
+    {
+      if (opts.quiet && cnt == 1)
+        std::cout << counts[j] << std::endl;
+      else
+        std::cout << countLabels[j] << ": " << counts[j] << std::endl;
+    }
+  }
+}
+
 /// Count & print primes and prime k-tuplets
 void sieve(const CmdOptions& opts)
 {
@@ -74,8 +395,20 @@ void sieve(const CmdOptions& opts)
     ps.setSieveSize(opts.sieveSize);
   if (opts.threads)
     ps.setNumThreads(opts.threads);
-  if (ps.isPrint())
-    ps.setNumThreads(1);
+
+  // Binary output format
+  if (ps.isFlag(PRINT_UINT32, PRINT_BITMAP))
+  {
+    if (!ps.isPrintPrimes() || ps.isPrintkTuplets())
+      throw primesieve_error("option --format requires --print (primes only)");
+
+    // The counts and the time are printed as text
+    // which would corrupt the binary output.
+    if (ps.isCountPrimes() || ps.isCountkTuplets() || opts.time)
+      throw primesieve_error("option --format cannot be used with --count or --time");
+
+    setBinaryStdout();
+  }
 
   if (opts.numbers.size() < 2)
     ps.setStop(opts.numbers[0]);
@@ -85,20 +418,54 @@ void sieve(const CmdOptions& opts)
     ps.setStop(opts.numbers[1]);
   }
 
+  uint64_t start = ps.getStart();
+  uint64_t stop = ps.getStop();
+
+  if (opts.shards)
+  {
+    uint64_t shardStart;
+    uint64_t shardStop;
+    ps.getShard(opts.shard - 1, opts.shards, shardStart, shardStop);
+    ps.setStart(shardStart);
+    ps.setStop(shardStop);
+
+    if (!opts.quiet)
+    {
+      if (shardStart <= shardStop)
+        std::cout << "Shard = [" << shardStart << ", " << shardStop << "]" << std::endl;
+      else
+        std::cout << "Shard = empty" << std::endl;
+    }
+  }
+
+  if (!opts.resultFile.empty() &&
+      (ps.isPrint() || !opts.piIndexFile.empty()))
+    throw primesieve_error("option --result requires --count (and no --pi-index)");
+
+  if (!opts.piIndexFile.empty() &&
+      countPrimesPiIndex(opts, ps))
+    return;
+
+  std::unique_ptr<Checkpoint> checkpoint;
+
+  if (!opts.checkpointFile.empty())
+  {
+    if (ps.isPrint())
+      throw primesieve_error("option --checkpoint requires --count");
+
+    checkpoint.reset(new Checkpoint(opts.checkpointFile, opts.resume));
+    ps.setCheckpoint(checkpoint.get());
+  }
+  else if (opts.resume)
+    throw primesieve_error("option --resume requires --checkpoint=FILE");
+
   if (!opts.quiet)
     printSettings(ps);
 
   ps.sieve();
 
-  const Array<std::string, 6> labels =
-  {
-    "Primes: ",
-    "Twin primes: ",
-    "Prime triplets: ",
-    "Prime quadruplets: ",
-    "Prime quintuplets: ",
-    "Prime sextuplets: "
-  };
+  if (!opts.resultFile.empty())
+    saveResult(opts, start, stop, ps);
 
   if (opts.time)
     printSeconds(ps.getSeconds());
@@ -116,7 +483,7 @@ void sieve(const CmdOptions& opts)
       if (opts.quiet && cnt == 1)
         std::cout << ps.getCount(i) << std::endl;
       else
-        std::cout << labels[i] << ps.getCount(i) << std::endl;
+        std::cout << countLabels[i] << ": " << ps.getCount(i) << std::endl;
     }
   }
 }
@@ -139,6 +506,15 @@ void nthPrime(const CmdOptions& opts)
   if (opts.threads)
     ps.setNumThreads(opts.threads);
 
+  PrimePiIndex index;
+  if (!opts.piIndexFile.empty())
+  {
+    index.load(opts.piIndexFile);
+    if (opts.threads)
+      index.setNumThreads(opts.threads);
+    ps.setPiIndex(&index);
+  }
+
   uint64_t nthPrime = 0;
   ps.setStart(start);
   ps.setStop(start + std::abs(n * 20));
@@ -223,6 +599,19 @@ void cpuInfo()
   else
     std::cout << "Logical CPU cores: unknown" << std::endl;
 
+  if (cpu.hasAffinityCpuCores())
+    std::cout << "Affinity CPU cores: " << cpu.affinityCpuCores() << std::endl;
+  else
+    std::cout << "Affinity CPU cores: unknown" << std::endl;
+
+  if (cpu.hasCpuQuota())
+    std::cout << "cgroup CPU quota: " << cpu.cpuQuota() << std::endl;
+  else
+    std::cout << "cgroup CPU quota: none" << std::endl;
+
+  // Default number of threads
+  std::cout << "Available CPU cores: " << ParallelSieve::getMaxThreads() << std::endl;
+
   // Enable on x86 CPUs
   #if defined(__x86_64__) || \
       defined(__i386__) || \
@@ -230,13 +619,28 @@ void cpuInfo()
       defined(_M_IX86) || \
       defined(__AVX512F__)
 
+    if (cpu.hasAVX2())
+      std::cout << "Has AVX2: yes" << std::endl;
+    else
+      std::cout << "Has AVX2: no" << std::endl;
+
     if (cpu.hasAVX512())
       std::cout << "Has AVX512: yes" << std::endl;
     else
       std::cout << "Has AVX512: no" << std::endl;
 
+    if (cpu.hasAVX512VPOPCNT())
+      std::cout << "Has AVX512 VPOPCNTDQ: yes" << std::endl;
+    else
+      std::cout << "Has AVX512 VPOPCNTDQ: no" << std::endl;
+
   #endif
 
+  if (cpu.hasNumaNodes())
+    std::cout << "NUMA nodes: " << cpu.numaNodes() << std::endl;
+  else
+    std::cout << "NUMA nodes: unknown" << std::endl;
+
   if (cpu.hasL1Cache())
     std::cout << "L1 cache size: " << (cpu.l1CacheBytes() >> 10) << " KiB" << std::endl;
 
@@ -284,6 +688,10 @@ void cpuInfo()
     std::cout << "L2 cache sharing: unknown" << std::endl;
     std::cout << "L3 cache sharing: unknown" << std::endl;
   }
+
+  const auto& tuning = primesieve::getEratTuning();
+  std::cout << "EratSmall factor: " << tuning.factorEratSmall << std::endl;
+  std::cout << "EratMedium factor: " << tuning.factorEratMedium << std::endl;
 }
 
 } // namespace
@@ -293,11 +701,19 @@ int main(int argc, char* argv[])
   try
   {
     CmdOptions opts = parseOptions(argc, argv);
+    setEratTuning(opts);
+
+    if (opts.pinThreads)
+      primesieve::ThreadPool::get().setPinThreads(true);
+    if (opts.hugePages)
+      primesieve::setHugePages(true);
 
     switch (opts.option)
     {
+      case OPTION_BUILD_INDEX: buildPiIndex(opts); break;
       case OPTION_CPU_INFO:    cpuInfo(); break;
       case OPTION_HELP:        help(/* exitCode */ 0); break;
+      case OPTION_MERGE:       merge(opts); break;
       case OPTION_NTH_PRIME:   nthPrime(opts); break;
       case OPTION_R:           RiemannR(opts); break;
       case OPTION_R_INVERSE:   RiemannR_inverse(opts); break;
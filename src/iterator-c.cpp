@@ -9,13 +9,16 @@
 ///
 
 #include <primesieve.h>
+#include <primesieve/config.hpp>
 #include <primesieve/IteratorHelper.hpp>
 #include <primesieve/PrimeGenerator.hpp>
 #include <primesieve/macros.hpp>
 #include <primesieve/Vector.hpp>
 
 #include <stdint.h>
+#include <algorithm>
 #include <cerrno>
+#include <cstddef>
 #include <exception>
 #include <limits>
 #include <iostream>
@@ -114,6 +117,44 @@ void primesieve_free_iterator(primesieve_iterator* it)
   }
 }
 
+void primesieve_set_batch_size(primesieve_iterator* it, size_t size)
+{
+  if (!it->memory)
+    it->memory = new IteratorData(it->start);
+
+  auto& iterData = getIterData(it);
+  iterData.batchSize = std::max<std::size_t>(size, config::MIN_ITERATOR_PRIMES);
+}
+
+void primesieve_next_primes(primesieve_iterator* it,
+                            uint64_t* primes,
+                            size_t n)
+{
+  while (n > 0)
+  {
+    std::size_t size;
+    const uint64_t* block = primesieve_next_prime_block(it, &size);
+
+    // primesieve_generate_next_primes() failed
+    if_unlikely(block[0] == PRIMESIEVE_ERROR)
+    {
+      std::fill_n(primes, n, PRIMESIEVE_ERROR);
+      return;
+    }
+
+    // Put back the primes that don't fit
+    if (size > n)
+    {
+      it->i -= size - n;
+      size = n;
+    }
+
+    std::copy_n(block, size, primes);
+    primes += size;
+    n -= size;
+  }
+}
+
 void primesieve_generate_next_primes(primesieve_iterator* it)
 {
   try
@@ -8,11 +8,15 @@
 ///
 
 #include <primesieve/iterator.hpp>
+#include <primesieve/config.hpp>
 #include <primesieve/IteratorHelper.hpp>
+#include <primesieve/PrefetchThread.hpp>
 #include <primesieve/PrimeGenerator.hpp>
 #include <primesieve/macros.hpp>
 
 #include <stdint.h>
+#include <algorithm>
+#include <cstddef>
 #include <limits>
 
 namespace {
@@ -106,11 +110,50 @@ void iterator::jump_to(uint64_t start,
     iterData.stop = start;
     iterData.dist = 0;
     iterData.include_start_number = true;
+    iterData.deletePrefetchThread();
     iterData.deletePrimeGenerator();
     iterData.deletePrimes();
   }
 }
 
+void iterator::set_prefetch(bool prefetch)
+{
+  if (!memory_)
+    memory_ = new IteratorData(start_);
+
+  auto& iterData = *(IteratorData*) memory_;
+  iterData.prefetch = prefetch;
+}
+
+void iterator::set_batch_size(std::size_t size)
+{
+  if (!memory_)
+    memory_ = new IteratorData(start_);
+
+  auto& iterData = *(IteratorData*) memory_;
+  iterData.batchSize = std::max<std::size_t>(size, config::MIN_ITERATOR_PRIMES);
+}
+
+void iterator::next_primes(uint64_t* primes, std::size_t n)
+{
+  while (n > 0)
+  {
+    std::size_t size;
+    const uint64_t* block = next_prime_block(&size);
+
+    // Put back the primes that don't fit
+    if (size > n)
+    {
+      i_ -= size - n;
+      size = n;
+    }
+
+    std::copy_n(block, size, primes);
+    primes += size;
+    n -= size;
+  }
+}
+
 void iterator::clear() noexcept
 {
   jump_to(0);
@@ -129,6 +172,32 @@ void iterator::generate_next_primes()
   auto& iterData = *(IteratorData*) memory_;
   auto& primes = iterData.primes;
 
+  if (iterData.prefetch ||
+      iterData.prefetchThread)
+  {
+    if (!iterData.prefetchThread)
+      iterData.prefetchThread = new PrefetchThread(iterData, start_, stop_hint_);
+
+    // The background thread has already generated the next
+    // primes, we swap them into our primes buffer and the
+    // background thread starts generating the next primes.
+    auto& prefetchThread = *iterData.prefetchThread;
+    prefetchThread.fillNextPrimes(primes, &size_, iterData.prefetch);
+    primes_ = primes.data();
+    i_ = 0;
+
+    // Prefetch mode has been disabled by the user,
+    // from now on the primes are generated by the
+    // main thread again.
+    if (!iterData.prefetch)
+    {
+      start_ = prefetchThread.getStart();
+      iterData.deletePrefetchThread();
+    }
+
+    return;
+  }
+
   while (true)
   {
     if (!iterData.primeGenerator)
@@ -162,6 +231,10 @@ void iterator::generate_prev_primes()
   auto& iterData = *(IteratorData*) memory_;
   auto& primes = iterData.primes;
 
+  // The background thread must be stopped
+  // before we can use the primeGenerator.
+  iterData.deletePrefetchThread();
+
   // Special case if generate_next_primes() has
   // been used before generate_prev_primes().
   if_unlikely(iterData.primeGenerator)
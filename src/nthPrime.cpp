@@ -7,19 +7,33 @@
 /// file in the top level directory.
 ///
 
-#include <primesieve/iterator.hpp>
+#include <primesieve/ParallelSieve.hpp>
 #include <primesieve/PrimeSieve.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/forward.hpp>
+#include <primesieve/intrinsics.hpp>
+#include <primesieve/littleendian_cast.hpp>
 #include <primesieve/macros.hpp>
 #include <primesieve/pmath.hpp>
+#include <primesieve/PrimePiIndex.hpp>
+#include <primesieve/PrimePiLMO.hpp>
 #include <primesieve/primesieve_error.hpp>
 #include <primesieve/RiemannR.hpp>
+#include <primesieve/SegmentSieve.hpp>
+#include <primesieve/ThreadPool.hpp>
+#include <primesieve/Vector.hpp>
 
 #include <stdint.h>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
+#include <limits>
 #include <string>
 
+using namespace primesieve;
+
 namespace {
 
 /// PrimePi(2^64)
@@ -31,14 +45,148 @@ uint64_t avgPrimeGap(uint64_t n)
   double x = (double) n;
   x = std::max(8.0, x);
   double logx = std::log(x);
-  // When we buffer primes using primesieve::iterator, we
-  // want to make sure we buffer primes up to the nth
-  // prime. Therefore we use +2 here, better to buffer
-  // slightly too many primes than not enough primes.
+  // We want to make sure we sieve up to the nth prime.
+  // Therefore we use +2 here, better to sieve slightly
+  // too many numbers than not enough numbers.
   double primeGap = logx + 2;
   return (uint64_t) primeGap;
 }
 
+/// Sieve [start, stop] and return the sieve array of the
+/// entire interval. Each byte corresponds to 30 numbers and
+/// its 8 bits correspond to the offsets
+/// { 7, 11, 13, 17, 19, 23, 29, 31 }. low is set to the
+/// number corresponding to the first byte.
+///
+Vector<uint8_t> sieveBitmap(PrimeSieve& ps,
+                            uint64_t start,
+                            uint64_t stop,
+                            uint64_t& low)
+{
+  ASSERT(start >= 7);
+  Vector<uint8_t> bitmap;
+  ps.setStart(start);
+  ps.setStop(stop);
+  SegmentSieve segmentSieve(ps);
+  low = start;
+
+  // The segments are adjacent
+  segmentSieve.sieve([&](const uint8_t* sieve, std::size_t size, uint64_t segmentLow)
+  {
+    if (bitmap.empty())
+      low = segmentLow;
+
+    std::size_t pos = (std::size_t) ((segmentLow - low) / 30);
+    bitmap.resize(pos + size);
+    std::copy_n(sieve, size, &bitmap[pos]);
+  });
+
+  // Pad with zeros to a multiple of 8 bytes
+  std::size_t size = bitmap.size();
+  bitmap.resize(ceilDiv(size, sizeof(uint64_t)) * sizeof(uint64_t));
+  std::fill(bitmap.begin() + size, bitmap.end(), (uint8_t) 0);
+
+  return bitmap;
+}
+
+/// Returns the nth (n >= 1) prime of the sieve array, or 0 if
+/// the sieve array contains fewer than n primes. We popcount
+/// whole 64-bit words until we reach the word that contains
+/// the nth prime, then we select the nth set bit of that word.
+/// Hence the cost is proportional to the number of words
+/// (not the number of primes).
+///
+uint64_t selectNthPrime(const Vector<uint8_t>& bitmap,
+                        uint64_t low,
+                        uint64_t n)
+{
+  ASSERT(n >= 1);
+  ASSERT(bitmap.size() % 8 == 0);
+
+  for (std::size_t i = 0; i < bitmap.size(); i += 8)
+  {
+    uint64_t bits = littleendian_cast<uint64_t>(&bitmap[i]);
+    uint64_t count = popcnt64(bits);
+
+    if (count >= n)
+    {
+      uint64_t bitIndex = select64(bits, n - 1);
+      return low + i * 30 + bitValues[bitIndex];
+    }
+
+    n -= count;
+  }
+
+  return 0;
+}
+
+/// Returns the nth (n >= 1) prime >= start.
+/// Sieves at most up to maxStop.
+///
+uint64_t nextNthPrime(PrimeSieve& ps,
+                      uint64_t start,
+                      uint64_t n,
+                      uint64_t dist,
+                      uint64_t maxStop = std::numeric_limits<uint64_t>::max())
+{
+  // The sieve array does not contain 2, 3 and 5
+  for (uint64_t prime : { 2, 3, 5 })
+    if (prime >= start && --n == 0)
+      return prime;
+
+  start = std::max<uint64_t>(start, 7);
+
+  while (true)
+  {
+    dist = inBetween(1, dist, config::MAX_NTHPRIME_DISTANCE);
+    uint64_t stop = std::min(checkedAdd(start, dist), maxStop);
+    uint64_t low;
+    auto bitmap = sieveBitmap(ps, start, stop, low);
+    uint64_t prime = selectNthPrime(bitmap, low, n);
+
+    if (prime)
+      return prime;
+    if (stop == maxStop)
+      throw primesieve_error("cannot generate primes > 2^64");
+
+    n -= popcount((const uint64_t*) bitmap.data(), bitmap.size() / 8);
+    start = stop + 1;
+    dist *= 2;
+  }
+}
+
+/// Returns the nth (n >= 1) prime <= stop
+uint64_t prevNthPrime(PrimeSieve& ps,
+                      uint64_t stop,
+                      uint64_t n,
+                      uint64_t dist)
+{
+  while (stop >= 7)
+  {
+    dist = inBetween(1, dist, config::MAX_NTHPRIME_DISTANCE);
+    uint64_t start = std::max<uint64_t>(checkedSub(stop, dist), 7);
+    uint64_t low;
+    auto bitmap = sieveBitmap(ps, start, stop, low);
+    uint64_t count = popcount((const uint64_t*) bitmap.data(), bitmap.size() / 8);
+
+    // The nth prime <= stop is the
+    // (count - n + 1)th prime >= start.
+    if (count >= n)
+      return selectNthPrime(bitmap, low, count - n + 1);
+
+    n -= count;
+    stop = start - 1;
+    dist *= 2;
+  }
+
+  // The sieve array does not contain 2, 3 and 5
+  for (uint64_t prime : { 5, 3, 2 })
+    if (prime <= stop && --n == 0)
+      return prime;
+
+  throw primesieve_error("nth_prime(n): invalid n, nth prime < 2 is impossible!");
+}
+
 } // namespace
 
 namespace primesieve {
@@ -57,6 +205,13 @@ uint64_t PrimeSieve::nthPrime(int64_t n, uint64_t start)
   else if ((uint64_t) n > max_n)
     throw primesieve_error("nth_prime(n): n must be <= " + std::to_string(max_n));
 
+  if (piIndex_)
+  {
+    uint64_t prime = nthPrimeIndex(n, start);
+    if (prime)
+      return prime;
+  }
+
   setStart(start);
   auto t1 = std::chrono::system_clock::now();
   uint64_t nApprox = checkedAdd(primePiApprox(start), n);
@@ -70,7 +225,7 @@ uint64_t PrimeSieve::nthPrime(int64_t n, uint64_t start)
   // large. For small n this if statement also avoids calling
   // countPrimes() and hence the initialization overhead of
   // O(x^0.5 log log x^0.5) occurs only once (instead of twice) when
-  // using primesieve::iterator further down.
+  // sieving the remaining distance further down.
   if (primeApprox - start > isqrt(primeApprox) / 10)
   {
     // Count primes > start
@@ -81,27 +236,21 @@ uint64_t PrimeSieve::nthPrime(int64_t n, uint64_t start)
   }
 
   // Here we are very close to the nth prime < sqrt(nth_prime),
-  // we simply iterate over the primes until we find it.
+  // we sieve the remaining distance and locate the nth prime
+  // in the sieve array.
+  PrimeSieve ps;
+  ps.setSieveSize(getSieveSize());
+
   if (countApprox < n)
   {
     start = checkedAdd(start, 1);
     uint64_t dist = (n - countApprox) * avgPrimeGap(primeApprox);
-    uint64_t stop = checkedAdd(start, dist);
-    primesieve::iterator iter(start, stop);
-    for (int64_t i = countApprox; i < n; i++)
-      prime = iter.next_prime();
+    prime = nextNthPrime(ps, start, n - countApprox, dist);
   }
   else // if (countApprox >= n)
   {
     uint64_t dist = (countApprox - n) * avgPrimeGap(primeApprox);
-    uint64_t stop = checkedSub(start, dist);
-    primesieve::iterator iter(start, stop);
-    for (int64_t i = countApprox; i >= n; i--)
-    {
-      prime = iter.prev_prime();
-      if_unlikely(prime == 0)
-        throw primesieve_error("nth_prime(n): invalid n, nth prime < 2 is impossible!");
-    }
+    prime = prevNthPrime(ps, start, countApprox - n + 1, dist);
   }
 
   auto t2 = std::chrono::system_clock::now();
@@ -122,6 +271,13 @@ uint64_t PrimeSieve::negativeNthPrime(int64_t n, uint64_t start)
   else if ((uint64_t) n > max_n)
     throw primesieve_error("nth_prime(n): abs(n) must be <= " + std::to_string(max_n));
 
+  if (piIndex_)
+  {
+    uint64_t prime = nthPrimeIndex(-n, start);
+    if (prime)
+      return prime;
+  }
+
   setStart(start);
   auto t1 = std::chrono::system_clock::now();
   uint64_t nApprox = checkedSub(primePiApprox(start), n);
@@ -135,7 +291,7 @@ uint64_t PrimeSieve::negativeNthPrime(int64_t n, uint64_t start)
   // large. For small n this if statement also avoids calling
   // countPrimes() and hence the initialization overhead of
   // O(x^0.5 log log x^0.5) occurs only once (instead of twice) when
-  // using primesieve::iterator further down.
+  // sieving the remaining distance further down.
   if (start - primeApprox > isqrt(start) / 10)
   {
     // Count primes < start
@@ -146,34 +302,408 @@ uint64_t PrimeSieve::negativeNthPrime(int64_t n, uint64_t start)
   }
 
   // Here we are very close to the nth prime < sqrt(nth_prime),
-  // we simply iterate over the primes until we find it.
+  // we sieve the remaining distance and locate the nth prime
+  // in the sieve array.
+  PrimeSieve ps;
+  ps.setSieveSize(getSieveSize());
+
   if (countApprox >= n)
   {
     uint64_t dist = (countApprox - n) * avgPrimeGap(start);
-    uint64_t stop = checkedAdd(start, dist);
-    primesieve::iterator iter(start, stop);
-    for (int64_t i = countApprox; i >= n; i--)
-      prime = iter.next_prime();
+    prime = nextNthPrime(ps, start, countApprox - n + 1, dist);
   }
   else // if (countApprox < n)
   {
     start = checkedSub(start, 1);
     uint64_t dist = (n - countApprox) * avgPrimeGap(start);
-    uint64_t stop = checkedSub(start, dist);
-    primesieve::iterator iter(start, stop);
-    for (int64_t i = countApprox; i < n; i++)
+    prime = prevNthPrime(ps, start, n - countApprox, dist);
+  }
+
+  auto t2 = std::chrono::system_clock::now();
+  std::chrono::duration<double> seconds = t2 - t1;
+  seconds_ = seconds.count();
+
+  return prime;
+}
+
+/// Find the nth prime using the prime count index: we count the
+/// primes up to a rigorous lower bound of the nth prime using
+/// the index and we only sieve the interval between the lower
+/// and upper bound of the nth prime, its width is about
+/// 2 * sqrt(nth prime) for nth primes <= 10^19.
+/// Returns 0 if using the index is slower than sieving the
+/// interval between start and the nth prime.
+///
+uint64_t PrimeSieve::nthPrimeIndex(int64_t n, uint64_t start)
+{
+  ASSERT(piIndex_);
+  ASSERT(n != 0);
+  uint64_t absN = (n < 0) ? 0 - (uint64_t) n : (uint64_t) n;
+  uint64_t piApprox = primePiApprox(start);
+
+  if (n > 0)
+  {
+    uint64_t nApprox = std::min(checkedAdd(piApprox, absN), max_n);
+    uint64_t primeApprox = nthPrimeApprox(nApprox);
+    if (!piIndex_->isUseful(checkedAdd(start, 1), primeApprox))
+      return 0;
+  }
+  else
+  {
+    uint64_t nApprox = checkedSub(piApprox, absN);
+    uint64_t primeApprox = nthPrimeApprox(nApprox);
+    if (!piIndex_->isUseful(primeApprox, start - 1))
+      return 0;
+  }
+
+  setStart(start);
+  auto t1 = std::chrono::system_clock::now();
+  uint64_t rank;
+
+  if (n > 0)
+    rank = piIndex_->countPrimes(0, start) + absN;
+  else
+  {
+    uint64_t pi = piIndex_->countPrimes(0, start - 1);
+    if (absN > pi)
+      throw primesieve_error("nth_prime(n): invalid n, nth prime < 2 is impossible!");
+    rank = pi - absN + 1;
+  }
+
+  uint64_t low = nthPrimeLower(rank);
+  uint64_t high = nthPrimeUpper(rank);
+
+  if (n > 0)
+    low = std::max(low, checkedAdd(start, 1));
+  else
+    high = std::min(high, start - 1);
+
+  // The nth prime is the kth prime >= low
+  uint64_t k = rank - piIndex_->countPrimes(0, low - 1);
+  uint64_t dist = k * avgPrimeGap(low);
+  PrimeSieve ps;
+  ps.setSieveSize(getSieveSize());
+  uint64_t prime = nextNthPrime(ps, low, k, dist, high);
+
+  auto t2 = std::chrono::system_clock::now();
+  std::chrono::duration<double> seconds = t2 - t1;
+  seconds_ = seconds.count();
+
+  return prime;
+}
+
+/// Find the nth prime of each n of the array using the rigorous
+/// bounds of the nth prime: we count the primes up to the lower
+/// bound of each nth prime using the pi index or the LMO algorithm
+/// (or by sieving the short distance from the previous lower bound)
+/// and we only sieve the interval between the lower and upper
+/// bound of each nth prime, its width is about 2 * sqrt(nth prime)
+/// for nth primes <= 10^19.
+///
+void ParallelSieve::nthPrimesBounds(const int64_t* n,
+                                    std::size_t size,
+                                    uint64_t start,
+                                    uint64_t* primes)
+{
+  const PrimePiIndex* piIndex = getPiIndex();
+
+  // Returns pi(x) using pi(y) = piY
+  auto primePi = [&](uint64_t x, uint64_t y, uint64_t piY)
+  {
+    if (x == y)
+      return piY;
+
+    uint64_t low = std::min(x, y) + 1;
+    uint64_t high = std::max(x, y);
+
+    if (piIndex && piIndex->isUseful(low, high))
+      return piIndex->countPrimes(0, x);
+    if (isPrimePiLMOUseful(low, high))
+      return primePiLMO(x, numThreads_);
+
+    ParallelSieve ps;
+    ps.setNumThreads(numThreads_);
+    ps.setSieveSize(getSieveSize());
+    uint64_t count = ps.countPrimes(low, high);
+    return (x > y) ? piY + count : piY - count;
+  };
+
+  struct Bracket
+  {
+    std::size_t index;
+    uint64_t rank;
+    uint64_t low;
+    uint64_t high;
+    uint64_t k;
+  };
+
+  uint64_t piStart = primePi(start, 0, 0);
+  uint64_t piPrev = (start > 0) ? primePi(start - 1, start, piStart) : 0;
+  Vector<Bracket> brackets(size);
+
+  for (std::size_t i = 0; i < size; i++)
+  {
+    uint64_t absN = (n[i] < 0) ? 0 - (uint64_t) n[i] : (uint64_t) n[i];
+    Bracket& b = brackets[i];
+    b.index = i;
+
+    if (n[i] >= 0)
     {
-      prime = iter.prev_prime();
-      if_unlikely(prime == 0)
+      b.rank = piStart + std::max<uint64_t>(absN, 1);
+      b.low = std::max(nthPrimeLower(b.rank), checkedAdd(start, 1));
+      b.high = nthPrimeUpper(b.rank);
+    }
+    else
+    {
+      if (absN > piPrev)
         throw primesieve_error("nth_prime(n): invalid n, nth prime < 2 is impossible!");
+
+      b.rank = piPrev - absN + 1;
+      b.low = nthPrimeLower(b.rank);
+      b.high = std::min(nthPrimeUpper(b.rank), start - 1);
     }
   }
 
+  std::sort(brackets.begin(), brackets.end(),
+            [](const Bracket& a, const Bracket& b) { return a.low < b.low; });
+
+  // The lower bounds > start are counted upwards from start
+  // and the lower bounds <= start downwards from start.
+  auto mid = std::upper_bound(brackets.begin(), brackets.end(), start,
+                              [](uint64_t x, const Bracket& b) { return x < b.low; });
+  uint64_t x = start;
+  uint64_t pi = piStart;
+
+  for (auto b = mid; b != brackets.end(); b++)
+  {
+    pi = primePi(b->low - 1, x, pi);
+    x = b->low - 1;
+    b->k = b->rank - pi;
+  }
+
+  x = start;
+  pi = piStart;
+
+  for (auto b = mid; b != brackets.begin();)
+  {
+    b--;
+    pi = primePi(b->low - 1, x, pi);
+    x = b->low - 1;
+    b->k = b->rank - pi;
+  }
+
+  if (brackets.empty())
+    return;
+
+  // The nth prime is the kth prime inside [low, high]
+  uint64_t dist = 0;
+  uint64_t stop = 0;
+
+  for (const Bracket& b : brackets)
+  {
+    dist = checkedAdd(dist, b.high - b.low);
+    stop = std::max(stop, b.high);
+  }
+
+  setStart(brackets[0].low);
+  setStop(stop);
+  int threads = inBetween(1, numThreads_, brackets.size());
+
+  // All threads share the sieving primes <= sqrt(stop_)
+  if (brackets.size() > 1 &&
+      isSievingPrimesTableSmall(threads, dist))
+    sievingPrimesTable_.init(isqrt(stop_), threads);
+  else
+    sievingPrimesTable_.clear();
+
+  std::atomic<std::size_t> next(0);
+
+  auto task = [&](int)
+  {
+    PrimeSieve ps(this);
+    std::size_t i;
+
+    while ((i = next.fetch_add(1, std::memory_order_relaxed)) < brackets.size())
+    {
+      const Bracket& b = brackets[i];
+      primes[b.index] = nextNthPrime(ps, b.low, b.k, b.k * avgPrimeGap(b.low), b.high);
+    }
+  };
+
+  ThreadPool::get().run(threads, task);
+}
+
+/// Find the nth prime > start (n > 0) or the nth prime < start
+/// (n < 0) for each n of the array, like nthPrime(n, start).
+/// If counting the primes using the pi index or the LMO algorithm
+/// is faster than sieving the interval that contains start and
+/// all nth primes, we use nthPrimesBounds(). Otherwise, instead
+/// of counting the primes up to each nth prime separately, we add
+/// a grid of stops around the approximation of each nth prime and
+/// count the primes up to all stops in a single parallel pass.
+/// Then each nth prime is located in the sieve array of the part
+/// between two adjacent stops, the threads share the sieving
+/// primes.
+///
+void ParallelSieve::nthPrimes(const int64_t* n,
+                              std::size_t size,
+                              uint64_t start,
+                              uint64_t* primes)
+{
+  auto t1 = std::chrono::system_clock::now();
+  uint64_t piApprox = primePiApprox(start);
+  Vector<uint64_t> primeApprox(size);
+  uint64_t low = start;
+  uint64_t high = start;
+
+  for (std::size_t i = 0; i < size; i++)
+  {
+    uint64_t absN = (n[i] < 0) ? 0 - (uint64_t) n[i] : (uint64_t) n[i];
+
+    if (n[i] >= 0)
+    {
+      if (absN > max_n)
+        throw primesieve_error("nth_prime(n): n must be <= " + std::to_string(max_n));
+
+      uint64_t nApprox = checkedAdd(piApprox, std::max<uint64_t>(absN, 1));
+      nApprox = std::min(nApprox, max_n);
+      primeApprox[i] = std::max(nthPrimeApprox(nApprox), start);
+    }
+    else
+    {
+      if (absN >= start)
+        throw primesieve_error("nth_prime(n): abs(n) must be < start");
+      else if (absN > max_n)
+        throw primesieve_error("nth_prime(n): abs(n) must be <= " + std::to_string(max_n));
+
+      uint64_t nApprox = checkedSub(piApprox, absN);
+      primeApprox[i] = std::min(nthPrimeApprox(nApprox), start);
+    }
+
+    low = std::min(low, primeApprox[i]);
+    high = std::max(high, primeApprox[i]);
+  }
+
+  const PrimePiIndex* piIndex = getPiIndex();
+
+  if ((piIndex && piIndex->isUseful(low, high)) ||
+      isPrimePiLMOUseful(low, high))
+  {
+    nthPrimesBounds(n, size, start, primes);
+    auto t2 = std::chrono::system_clock::now();
+    std::chrono::duration<double> seconds = t2 - t1;
+    seconds_ = seconds.count();
+    return;
+  }
+
+  Vector<uint64_t> stops;
+  stops.push_back(start);
+
+  // The rank of the nth prime < start
+  // depends on the primes <= start - 1.
+  if (start > 0)
+    stops.push_back(start - 1);
+
+  for (uint64_t approx : primeApprox)
+  {
+    uint64_t grid = config::NTH_PRIMES_GRID;
+    uint64_t step = std::max<uint64_t>(isqrt(approx) / grid, 1);
+    stops.push_back(approx);
+
+    for (uint64_t j = 1; j <= grid; j++)
+    {
+      stops.push_back(checkedSub(approx, step * j));
+      stops.push_back(checkedAdd(approx, step * j));
+    }
+  }
+
+  std::sort(stops.begin(), stops.end());
+  stops.resize(std::unique(stops.begin(), stops.end()) - stops.begin());
+  setStart(stops.front());
+  setStop(stops.back());
+
+  // counts[i] = number of primes inside [stops[0], stops[i]]
+  Vector<uint64_t> counts(stops.size());
+  countPrefixes(stops.data(), stops.size(), counts.data());
+
+  auto primePi = [&](uint64_t x)
+  {
+    std::size_t i = std::lower_bound(stops.begin(), stops.end(), x) - stops.begin();
+    ASSERT(i < stops.size() && stops[i] == x);
+    return counts[i];
+  };
+
+  struct NthPrime
+  {
+    std::size_t index;
+    uint64_t rank;
+  };
+
+  // The nth primes with 1 <= rank <= counts.back()
+  // are located inside [stops[0], stops.back()].
+  Vector<NthPrime> nthPrimes;
+  Vector<std::size_t> outside;
+
+  for (std::size_t i = 0; i < size; i++)
+  {
+    uint64_t absN = (n[i] < 0) ? 0 - (uint64_t) n[i] : (uint64_t) n[i];
+    uint64_t rank = 0;
+
+    if (n[i] >= 0)
+      rank = primePi(start) + std::max<uint64_t>(absN, 1);
+    else if (absN <= primePi(start - 1))
+      rank = primePi(start - 1) - absN + 1;
+
+    if (rank >= 1 && rank <= counts.back())
+      nthPrimes.push_back({ i, rank });
+    else
+      outside.push_back(i);
+  }
+
+  if (!nthPrimes.empty())
+  {
+    int threads = inBetween(1, numThreads_, nthPrimes.size());
+
+    // All threads share the sieving primes <= sqrt(stop_)
+    if (nthPrimes.size() > 1 &&
+        isSievingPrimesTableSmall(threads, getDistance()))
+      sievingPrimesTable_.init(isqrt(stop_), threads);
+    else
+      sievingPrimesTable_.clear();
+
+    std::atomic<std::size_t> next(0);
+
+    auto task = [&](int)
+    {
+      PrimeSieve ps(this);
+      std::size_t i;
+
+      while ((i = next.fetch_add(1, std::memory_order_relaxed)) < nthPrimes.size())
+      {
+        // The nth prime is inside [first, stops[j]]
+        uint64_t rank = nthPrimes[i].rank;
+        std::size_t j = std::lower_bound(counts.begin(), counts.end(), rank) - counts.begin();
+        uint64_t first = (j > 0) ? stops[j - 1] + 1 : stops[0];
+        uint64_t k = (j > 0) ? rank - counts[j - 1] : rank;
+        uint64_t dist = k * avgPrimeGap(stops[j]);
+        primes[nthPrimes[i].index] = nextNthPrime(ps, first, k, dist, stops[j]);
+      }
+    };
+
+    ThreadPool::get().run(threads, task);
+  }
+
+  // The approximation of these nth primes was too far off
+  for (std::size_t i : outside)
+  {
+    ParallelSieve ps;
+    ps.setNumThreads(numThreads_);
+    primes[i] = ps.nthPrime(n[i], start);
+  }
+
   auto t2 = std::chrono::system_clock::now();
   std::chrono::duration<double> seconds = t2 - t1;
   seconds_ = seconds.count();
-
-  return prime;
 }
 
 } // namespace
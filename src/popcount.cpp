@@ -11,20 +11,48 @@
 #include <primesieve/intrinsics.hpp>
 #include <primesieve/forward.hpp>
 #include <stdint.h>
+#include <algorithm>
 
 /// For CPU architectures that have a POPCNT instruction, we use
 /// that to count the number of 1 bits in the sieve array as
-/// this will generally provide the best performance. For CPU
-/// architectures without POPCNT we use the portable Harley-Seal
-/// popcount algorithm further down.
+/// this will generally provide the best performance. On x64
+/// CPUs we additionally use AVX512 VPOPCNTDQ or AVX2 if the CPU
+/// supports it. For CPU architectures without POPCNT we use the
+/// portable Harley-Seal popcount algorithm further down.
 ///
 #if defined(__x86_64__) || \
     defined(_M_X64) /* MSVC */ || \
    (defined(__ARM_NEON) || defined(__aarch64__))
 
-namespace primesieve {
+#if defined(__AVX512F__) && \
+    defined(__AVX512VPOPCNTDQ__) && \
+    __has_include(<immintrin.h>)
+  #include <immintrin.h>
+  #define ENABLE_AVX512_VPOPCNT
+#else
+  #if defined(ENABLE_MULTIARCH_AVX512_VPOPCNT) && \
+      __has_include(<immintrin.h>)
+    #include <primesieve/cpu_supports_avx512_vpopcnt.hpp>
+    #include <immintrin.h>
+    #define ENABLE_AVX512_VPOPCNT
+  #endif
+  #if defined(__AVX2__) && \
+      __has_include(<immintrin.h>)
+    #include <immintrin.h>
+    #define ENABLE_AVX2
+  #else
+    #if defined(ENABLE_MULTIARCH_AVX2) && \
+        __has_include(<immintrin.h>)
+      #include <primesieve/cpu_supports_avx2.hpp>
+      #include <immintrin.h>
+      #define ENABLE_AVX2
+    #endif
+  #endif
+#endif
 
-uint64_t popcount(const uint64_t* array, uint64_t size)
+namespace {
+
+uint64_t popcount_default(const uint64_t* array, uint64_t size)
 {
   uint64_t i;
   uint64_t limit = size - size % 4;
@@ -43,6 +71,216 @@ uint64_t popcount(const uint64_t* array, uint64_t size)
   return cnt;
 }
 
+#if defined(ENABLE_AVX512_VPOPCNT)
+
+#if !defined(__AVX512VPOPCNTDQ__)
+  __attribute__ ((target ("avx512f,avx512vpopcntdq")))
+#endif
+uint64_t popcount_avx512(const uint64_t* array, uint64_t size)
+{
+  __m512i cnt1 = _mm512_setzero_si512();
+  __m512i cnt2 = _mm512_setzero_si512();
+  uint64_t limit = size - size % 16;
+  uint64_t i = 0;
+
+  for (; i < limit; i += 16)
+  {
+    __m512i vec1 = _mm512_loadu_si512(&array[i+0]);
+    __m512i vec2 = _mm512_loadu_si512(&array[i+8]);
+    cnt1 = _mm512_add_epi64(cnt1, _mm512_popcnt_epi64(vec1));
+    cnt2 = _mm512_add_epi64(cnt2, _mm512_popcnt_epi64(vec2));
+  }
+
+  // Process the remaining 0 - 15 words
+  for (; i < size; i += 8)
+  {
+    __mmask8 mask = (__mmask8) (0xff >> (8 - std::min<uint64_t>(size - i, 8)));
+    __m512i vec = _mm512_maskz_loadu_epi64(mask, &array[i]);
+    cnt1 = _mm512_add_epi64(cnt1, _mm512_popcnt_epi64(vec));
+  }
+
+  // We don't use _mm512_reduce_add_epi64() because it
+  // causes -Wmaybe-uninitialized warnings with GCC.
+  uint64_t cnt[8];
+  cnt1 = _mm512_add_epi64(cnt1, cnt2);
+  _mm512_storeu_si512(cnt, cnt1);
+
+  return cnt[0] + cnt[1] + cnt[2] + cnt[3] +
+         cnt[4] + cnt[5] + cnt[6] + cnt[7];
+}
+
+#endif
+
+#if defined(ENABLE_AVX2)
+
+/// Count the 1 bits of each nibble using a 16 entries lookup
+/// table (VPSHUFB) and then sum up the bytes of each 64-bit
+/// word using VPSADBW (Wojciech Muła's algorithm).
+///
+#if !defined(__AVX2__)
+  __attribute__ ((target ("avx2")))
+#endif
+__m256i popcnt256(__m256i vec)
+{
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low4 = _mm256_set1_epi8(0x0f);
+  __m256i lo = _mm256_and_si256(vec, low4);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(vec, 4), low4);
+  __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+}
+
+/// Carry-save adder (CSA).
+/// @see Chapter 5 in "Hacker's Delight".
+///
+#if !defined(__AVX2__)
+  __attribute__ ((target ("avx2")))
+#endif
+void CSA256(__m256i& h, __m256i& l, __m256i a, __m256i b, __m256i c)
+{
+  __m256i u = _mm256_xor_si256(a, b);
+  h = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+  l = _mm256_xor_si256(u, c);
+}
+
+/// AVX2 Harley-Seal popcount (4th iteration), the same algorithm
+/// as the portable popcount() further down but using 256-bit
+/// vectors. Since AVX2 has no vector popcount instruction, we
+/// use Wojciech Muła's algorithm to count the 1 bits of the
+/// sixteens vector.
+/// @see "Faster Population Counts Using AVX2 Instructions"
+///      by Wojciech Muła, Nathan Kurz, Daniel Lemire.
+///
+#if !defined(__AVX2__)
+  __attribute__ ((target ("avx2")))
+#endif
+uint64_t popcount_avx2(const uint64_t* array, uint64_t size)
+{
+  const __m256i* vec = (const __m256i*) array;
+  __m256i total = _mm256_setzero_si256();
+  __m256i ones = _mm256_setzero_si256();
+  __m256i twos = _mm256_setzero_si256();
+  __m256i fours = _mm256_setzero_si256();
+  __m256i eights = _mm256_setzero_si256();
+  __m256i sixteens;
+  __m256i twosA, twosB, foursA, foursB, eightsA, eightsB;
+  uint64_t limit = size / 4 - (size / 4) % 16;
+  uint64_t i = 0;
+
+  for (; i < limit; i += 16)
+  {
+    CSA256(twosA, ones, ones, _mm256_loadu_si256(vec + i + 0), _mm256_loadu_si256(vec + i + 1));
+    CSA256(twosB, ones, ones, _mm256_loadu_si256(vec + i + 2), _mm256_loadu_si256(vec + i + 3));
+    CSA256(foursA, twos, twos, twosA, twosB);
+    CSA256(twosA, ones, ones, _mm256_loadu_si256(vec + i + 4), _mm256_loadu_si256(vec + i + 5));
+    CSA256(twosB, ones, ones, _mm256_loadu_si256(vec + i + 6), _mm256_loadu_si256(vec + i + 7));
+    CSA256(foursB, twos, twos, twosA, twosB);
+    CSA256(eightsA, fours, fours, foursA, foursB);
+    CSA256(twosA, ones, ones, _mm256_loadu_si256(vec + i + 8), _mm256_loadu_si256(vec + i + 9));
+    CSA256(twosB, ones, ones, _mm256_loadu_si256(vec + i + 10), _mm256_loadu_si256(vec + i + 11));
+    CSA256(foursA, twos, twos, twosA, twosB);
+    CSA256(twosA, ones, ones, _mm256_loadu_si256(vec + i + 12), _mm256_loadu_si256(vec + i + 13));
+    CSA256(twosB, ones, ones, _mm256_loadu_si256(vec + i + 14), _mm256_loadu_si256(vec + i + 15));
+    CSA256(foursB, twos, twos, twosA, twosB);
+    CSA256(eightsB, fours, fours, foursA, foursB);
+    CSA256(sixteens, eights, eights, eightsA, eightsB);
+
+    total = _mm256_add_epi64(total, popcnt256(sixteens));
+  }
+
+  total = _mm256_slli_epi64(total, 4);
+  total = _mm256_add_epi64(total, _mm256_slli_epi64(popcnt256(eights), 3));
+  total = _mm256_add_epi64(total, _mm256_slli_epi64(popcnt256(fours), 2));
+  total = _mm256_add_epi64(total, _mm256_slli_epi64(popcnt256(twos), 1));
+  total = _mm256_add_epi64(total, popcnt256(ones));
+
+  uint64_t cnt[4];
+  _mm256_storeu_si256((__m256i*) cnt, total);
+  uint64_t sum = cnt[0] + cnt[1] + cnt[2] + cnt[3];
+
+  // Process the remaining 0 - 63 words
+  for (i *= 4; i < size; i++)
+    sum += popcnt64(array[i]);
+
+  return sum;
+}
+
+#endif
+
+} // namespace
+
+namespace primesieve {
+
+uint64_t popcount(const uint64_t* array, uint64_t size)
+{
+  #if defined(__AVX512F__) && \
+      defined(__AVX512VPOPCNTDQ__)
+    return popcount_avx512(array, size);
+  #else
+    #if defined(ENABLE_AVX512_VPOPCNT)
+      if (cpu_supports_avx512_vpopcnt)
+        return popcount_avx512(array, size);
+    #endif
+    #if defined(__AVX2__)
+      return popcount_avx2(array, size);
+    #else
+      #if defined(ENABLE_AVX2)
+        if (cpu_supports_avx2)
+          return popcount_avx2(array, size);
+      #endif
+      return popcount_default(array, size);
+    #endif
+  #endif
+}
+
+/// Used for testing, count the 1 bits using the given
+/// popcount kernel. Returns false if the kernel has not
+/// been compiled or if it is not supported by the CPU.
+///
+bool popcount(const uint64_t* array,
+              uint64_t size,
+              PopcountKernel kernel,
+              uint64_t& count)
+{
+  switch (kernel)
+  {
+    case POPCOUNT_DEFAULT:
+      count = popcount_default(array, size);
+      return true;
+
+    case POPCOUNT_AVX2:
+      #if defined(__AVX2__)
+        count = popcount_avx2(array, size);
+        return true;
+      #elif defined(ENABLE_AVX2)
+        if (cpu_supports_avx2)
+        {
+          count = popcount_avx2(array, size);
+          return true;
+        }
+      #endif
+      return false;
+
+    case POPCOUNT_AVX512:
+      #if defined(__AVX512F__) && \
+          defined(__AVX512VPOPCNTDQ__)
+        count = popcount_avx512(array, size);
+        return true;
+      #elif defined(ENABLE_AVX512_VPOPCNT)
+        if (cpu_supports_avx512_vpopcnt)
+        {
+          count = popcount_avx512(array, size);
+          return true;
+        }
+      #endif
+      return false;
+  }
+
+  return false;
+}
+
 } // namespace
 
 #else
@@ -120,6 +358,21 @@ uint64_t popcount(const uint64_t* array, uint64_t size)
   return total;
 }
 
+/// Used for testing, only the portable
+/// Harley-Seal kernel is available.
+///
+bool popcount(const uint64_t* array,
+              uint64_t size,
+              PopcountKernel kernel,
+              uint64_t& count)
+{
+  if (kernel != POPCOUNT_DEFAULT)
+    return false;
+
+  count = popcount(array, size);
+  return true;
+}
+
 } // namespace
 
 #endif
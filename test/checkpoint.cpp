@@ -0,0 +1,178 @@
+///
+/// @file   checkpoint.cpp
+/// @brief  Count primes with a checkpoint file, then resume
+///         from a checkpoint file of an interrupted
+///         computation.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/Checkpoint.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/primesieve_error.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+std::vector<uint64_t> readFile(const std::string& filename)
+{
+  std::vector<uint64_t> words;
+  std::FILE* file = std::fopen(filename.c_str(), "rb");
+  unsigned char bytes[8];
+
+  while (file && std::fread(bytes, 1, 8, file) == 8)
+  {
+    uint64_t n = 0;
+    for (int i = 0; i < 8; i++)
+      n |= (uint64_t) bytes[i] << (i * 8);
+    words.push_back(n);
+  }
+
+  if (file)
+    std::fclose(file);
+
+  return words;
+}
+
+void writeFile(const std::string& filename, const std::vector<uint64_t>& words)
+{
+  std::FILE* file = std::fopen(filename.c_str(), "wb");
+  for (uint64_t n : words)
+  {
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++)
+      bytes[i] = (unsigned char) (n >> (i * 8));
+    std::fwrite(bytes, 1, 8, file);
+  }
+  std::fclose(file);
+}
+
+int main()
+{
+  std::string filename = "primesieve_test_checkpoint.bin";
+  uint64_t start = (uint64_t) 1e12 + 1;
+  uint64_t stop = start + (uint64_t) 3e9;
+  int flags = COUNT_PRIMES | COUNT_TWINS;
+  uint64_t primes = count_primes(start, stop);
+  uint64_t twins = count_twins(start, stop);
+
+  {
+    Checkpoint checkpoint(filename, false);
+    ParallelSieve ps;
+    ps.setFlags(flags);
+    ps.setCheckpoint(&checkpoint);
+    ps.sieve(start, stop);
+    std::cout << "Checkpoint PrimePi(" << start << ", " << stop << ") = " << ps.getCount(0);
+    check(ps.getCount(0) == primes);
+    std::cout << "Checkpoint Twins(" << start << ", " << stop << ") = " << ps.getCount(1);
+    check(ps.getCount(1) == twins);
+  }
+
+  // Format: magic, start, stop, flags, chunk distance,
+  // chunks, 6 counts, number of ranges, ranges.
+  std::vector<uint64_t> words = readFile(filename);
+  std::cout << "Checkpoint file size = " << words.size() * 8;
+  check(words.size() == 15 && words[1] == start && words[2] == stop);
+  uint64_t chunkDist = words[4];
+  uint64_t chunks = words[5];
+  std::cout << "Checkpoint chunks = " << chunks;
+  check(chunks > 4 && words[12] == 1 && words[13] == 0 && words[14] == chunks - 1);
+
+  // Resume a finished computation
+  {
+    Checkpoint checkpoint(filename, true);
+    ParallelSieve ps;
+    ps.setFlags(flags);
+    ps.setCheckpoint(&checkpoint);
+    ps.sieve(start, stop);
+    std::cout << "Resume finished PrimePi = " << ps.getCount(0);
+    check(ps.getCount(0) == primes);
+  }
+
+  // Simulate an interrupted computation: only the chunks
+  // 1 and 3 have been finished. Chunk i is
+  // [align(start + i * chunkDist) + 1, align(start + (i + 1) * chunkDist)]
+  // with align(n) = n + 32 - n % 30.
+  auto align = [&](uint64_t n) { return std::min(n + 32 - n % 30, stop); };
+  uint64_t c1 = count_primes(align(start + chunkDist) + 1, align(start + chunkDist * 2));
+  uint64_t c3 = count_primes(align(start + chunkDist * 3) + 1, align(start + chunkDist * 4));
+  uint64_t t1 = count_twins(align(start + chunkDist) + 1, align(start + chunkDist * 2));
+  uint64_t t3 = count_twins(align(start + chunkDist * 3) + 1, align(start + chunkDist * 4));
+  words.resize(6);
+  words.insert(words.end(), { c1 + c3, t1 + t3, 0, 0, 0, 0, 2, 1, 1, 3, 3 });
+
+  // The number of threads may differ from the
+  // interrupted computation.
+  for (int threads : { 1, 3 })
+  {
+    writeFile(filename, words);
+    Checkpoint checkpoint(filename, true);
+    ParallelSieve ps;
+    ps.setFlags(flags);
+    ps.setNumThreads(threads);
+    ps.setCheckpoint(&checkpoint);
+    ps.sieve(start, stop);
+    std::cout << "Resume PrimePi(" << start << ", " << stop << ") = " << ps.getCount(0);
+    check(ps.getCount(0) == primes);
+    std::cout << "Resume Twins(" << start << ", " << stop << ") = " << ps.getCount(1);
+    check(ps.getCount(1) == twins);
+  }
+
+  // Resuming a different computation must fail
+  try
+  {
+    Checkpoint checkpoint(filename, true);
+    ParallelSieve ps;
+    ps.setFlags(flags);
+    ps.setCheckpoint(&checkpoint);
+    ps.sieve(start, stop + 1);
+    std::cout << "Resume different interval";
+    check(false);
+  }
+  catch (const primesieve_error& e)
+  {
+    std::cout << "Resume different interval: " << e.what();
+    check(true);
+  }
+
+  // Truncated checkpoint file
+  words.resize(10);
+  writeFile(filename, words);
+
+  try
+  {
+    Checkpoint checkpoint(filename, true);
+    std::cout << "Load truncated checkpoint";
+    check(false);
+  }
+  catch (const primesieve_error& e)
+  {
+    std::cout << "Load truncated checkpoint: " << e.what();
+    check(true);
+  }
+
+  std::remove(filename.c_str());
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+///
+/// @file   count_ktuplets_kernels.cpp
+/// @brief  Compare each countAllkTuplets() kernel (default,
+///         AVX2, AVX512) with a simple scalar implementation
+///         that checks the k-tuplet bit patterns byte by byte.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/CountPrintPrimes.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+/// The 8 bits of each sieve byte correspond to the offsets
+/// { 7, 11, 13, 17, 19, 23, 29, 31 }, these are the bit
+/// patterns of the prime k-tuplets within a byte.
+///
+const std::vector<std::vector<uint64_t>> patterns =
+{
+  { },                        // Prime numbers, unused
+  { 0x06, 0x18, 0xc0 },       // Twin primes
+  { 0x07, 0x0e, 0x1c, 0x38 }, // Prime triplets
+  { 0x1e },                   // Prime quadruplets
+  { 0x1f, 0x3e },             // Prime quintuplets
+  { 0x3f }                    // Prime sextuplets
+};
+
+void countScalar(const uint64_t* sieve, std::size_t size, uint64_t* counts)
+{
+  for (std::size_t i = 0; i < size; i++)
+    for (int j = 0; j < 8; j++)
+    {
+      uint64_t byte = (sieve[i] >> (j * 8)) & 0xff;
+      for (int k = 1; k < 6; k++)
+        for (uint64_t pattern : patterns[k])
+          if ((byte & pattern) == pattern)
+            counts[k]++;
+    }
+}
+
+bool isEqual(const uint64_t* sieve,
+             std::size_t size,
+             kTupletsKernel kernel)
+{
+  uint64_t counts[6] = { 0, 0, 0, 0, 0, 0 };
+  uint64_t expected[6] = { 0, 0, 0, 0, 0, 0 };
+  countAllkTuplets(sieve, size, kernel, counts);
+  countScalar(sieve, size, expected);
+
+  for (int k = 0; k < 6; k++)
+    if (counts[k] != expected[k])
+      return false;
+
+  return true;
+}
+
+int main()
+{
+  const char* names[] = { "default", "AVX2", "AVX512" };
+  kTupletsKernel kernels[] = { KTUPLETS_DEFAULT, KTUPLETS_AVX2, KTUPLETS_AVX512 };
+  std::vector<uint64_t> sieve(1000);
+  uint64_t seed = 1;
+
+  // Random words, with runs of all 0 and all 1 bits
+  for (std::size_t i = 0; i < sieve.size(); i++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    if (i % 100 < 10)
+      sieve[i] = 0;
+    else if (i % 100 < 20)
+      sieve[i] = ~0ull;
+    else
+      sieve[i] = seed ^ (seed >> 29);
+  }
+
+  // Each of the 256 byte values, repeated
+  // at every byte position within a word.
+  std::vector<uint64_t> bytes;
+  for (uint64_t i = 0; i < 256; i++)
+    for (int j = 0; j < 8; j++)
+      bytes.push_back(i << (j * 8));
+
+  // Every byte contains a prime sextuplet
+  std::vector<uint64_t> sextuplets(100, 0x3f3f3f3f3f3f3f3full);
+
+  for (int k = 0; k < 3; k++)
+  {
+    uint64_t counts[6] = { 0, 0, 0, 0, 0, 0 };
+
+    if (!countAllkTuplets(sieve.data(), 0, kernels[k], counts))
+    {
+      std::cout << "countAllkTuplets " << names[k] << " kernel not supported by CPU\n";
+      continue;
+    }
+
+    // All lengths 0 - 300 (odd lengths and all tails
+    // shorter than one vector block), at different
+    // (unaligned) offsets.
+    bool OK = true;
+
+    for (std::size_t offset = 0; offset < 4; offset++)
+      for (std::size_t size = 0; size <= 300; size++)
+        OK &= isEqual(&sieve[offset], size, kernels[k]);
+
+    std::cout << "countAllkTuplets " << names[k] << " kernel, random, size = 0 - 300";
+    check(OK);
+
+    std::cout << "countAllkTuplets " << names[k] << " kernel, random, size = " << sieve.size();
+    check(isEqual(sieve.data(), sieve.size(), kernels[k]));
+
+    std::cout << "countAllkTuplets " << names[k] << " kernel, all byte values";
+    check(isEqual(bytes.data(), bytes.size(), kernels[k]));
+
+    OK = true;
+    for (std::size_t size = 0; size <= sextuplets.size(); size++)
+      OK &= isEqual(sextuplets.data(), size, kernels[k]);
+
+    std::cout << "countAllkTuplets " << names[k] << " kernel, all sextuplets";
+    check(OK);
+  }
+
+  uint64_t counts[6] = { 0, 0, 0, 0, 0, 0 };
+  uint64_t expected[6] = { 0, 0, 0, 0, 0, 0 };
+  countAllkTuplets(sieve.data(), sieve.size(), counts);
+  countScalar(sieve.data(), sieve.size(), expected);
+  bool OK = true;
+  for (int k = 0; k < 6; k++)
+    OK &= counts[k] == expected[k];
+
+  std::cout << "countAllkTuplets(sieve, " << sieve.size() << ") = " << counts[1];
+  check(OK);
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
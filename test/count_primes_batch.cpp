@@ -0,0 +1,101 @@
+///
+/// @file   count_primes_batch.cpp
+/// @brief  Count the primes and prime k-tuplets inside many
+///         (overlapping, nested, tiny, far apart) intervals
+///         using a single count_*_batch() call.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  std::vector<std::pair<uint64_t, uint64_t>> intervals =
+  {
+    { 0, 0 }, { 0, 1 }, { 2, 2 }, { 3, 7 }, { 4, 4 },
+    { 0, 32 }, { 5, 33 }, { 11, 17 }, { 100, 50 },
+    { 0, 100000 }, { 1000, 2000 }, { 1990, 2100 },
+    { (uint64_t) 1e9, (uint64_t) 1e9 + 1000 },
+    { (uint64_t) 1e9 + 500, (uint64_t) 1e9 + 1e7 },
+    { (uint64_t) 1e9 + 2000, (uint64_t) 1e9 + 3000 },
+    { (uint64_t) 1e12, (uint64_t) 1e12 + 100000 },
+    { (uint64_t) 1e12 + 17, (uint64_t) 1e12 + 17 },
+    { (uint64_t) 1e15, (uint64_t) 1e15 + 3e7 },
+    { (uint64_t) 1e15 + 1e8, (uint64_t) 1e15 + 1e8 + 1000 },
+    { (uint64_t) 1e15 + 1e12, (uint64_t) 1e15 + 1e12 + 1e6 }
+  };
+
+  // Many tiny intervals, some of them are adjacent
+  for (uint64_t i = 0; i < 100; i++)
+  {
+    uint64_t start = (uint64_t) 1e14 + i * 29 * 1000;
+    intervals.push_back({ start, start + 29 * 1000 - 1 });
+    intervals.push_back({ start + i, start + i * 7 });
+  }
+
+  auto primes = count_primes_batch(intervals);
+  auto twins = count_twins_batch(intervals);
+  auto triplets = count_triplets_batch(intervals);
+  auto sextuplets = count_sextuplets_batch(intervals);
+
+  check(primes.size() == intervals.size());
+
+  for (std::size_t i = 0; i < intervals.size(); i++)
+  {
+    uint64_t start = intervals[i].first;
+    uint64_t stop = intervals[i].second;
+
+    std::cout << "PrimePi(" << start << ", " << stop << ") = " << primes[i];
+    check(primes[i] == count_primes(start, stop));
+    std::cout << "Twins(" << start << ", " << stop << ") = " << twins[i];
+    check(twins[i] == count_twins(start, stop));
+    std::cout << "Triplets(" << start << ", " << stop << ") = " << triplets[i];
+    check(triplets[i] == count_triplets(start, stop));
+    std::cout << "Sextuplets(" << start << ", " << stop << ") = " << sextuplets[i];
+    check(sextuplets[i] == count_sextuplets(start, stop));
+  }
+
+  // Quadruplets and quintuplets near 0
+  for (uint64_t i = 0; i < 200; i++)
+    intervals.push_back({ i, i * 13 });
+
+  auto quadruplets = count_quadruplets_batch(intervals);
+  auto quintuplets = count_quintuplets_batch(intervals);
+
+  for (std::size_t i = 0; i < intervals.size(); i++)
+  {
+    uint64_t start = intervals[i].first;
+    uint64_t stop = intervals[i].second;
+
+    std::cout << "Quadruplets(" << start << ", " << stop << ") = " << quadruplets[i];
+    check(quadruplets[i] == count_quadruplets(start, stop));
+    std::cout << "Quintuplets(" << start << ", " << stop << ") = " << quintuplets[i];
+    check(quintuplets[i] == count_quintuplets(start, stop));
+  }
+
+  check(count_primes_batch({}).empty());
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -75,9 +75,31 @@ int main()
     return 1;
   }
 
+  if (cpu.hasLogicalCpuCores() &&
+      cpu.availableCpuCores() > cpu.logicalCpuCores())
+  {
+    std::cerr << "Invalid available CPU cores: " << cpu.availableCpuCores() << std::endl;
+    return 1;
+  }
+
+  if (cpu.hasAffinityCpuCores() &&
+      cpu.availableCpuCores() > cpu.affinityCpuCores())
+  {
+    std::cerr << "Invalid available CPU cores: " << cpu.availableCpuCores() << std::endl;
+    return 1;
+  }
+
+  if (!cpu.hasCpuQuota() &&
+      cpu.cpuQuota() != 0)
+  {
+    std::cerr << "Invalid cgroup CPU quota: " << cpu.cpuQuota() << std::endl;
+    return 1;
+  }
+
   if (cpu.hasCpuName())
     std::cout << cpu.cpuName() << std::endl;
 
+  std::cout << "Available CPU cores: " << cpu.availableCpuCores() << std::endl;
   std::cout << "L1 cache size: " << (cpu.l1CacheBytes() >> 10) << " KiB" << std::endl;
   std::cout << "L2 cache size: " << (cpu.l2CacheBytes() >> 10) << " KiB" << std::endl;
   std::cout << "L3 cache size: " << (cpu.l3CacheBytes() >> 10) << " KiB" << std::endl;
@@ -0,0 +1,86 @@
+///
+/// @file   erat_tuning.cpp
+/// @brief  Test that the primes are counted correctly using
+///         different EratSmall, EratMedium & EratBig thresholds.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/config.hpp>
+#include <primesieve/EratTuning.hpp>
+#include <primesieve/Vector.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  // The defaults do not depend on the CPU
+  std::cout << "Default factors: " << getEratTuning().factorEratSmall << ", " << getEratTuning().factorEratMedium;
+  check(getEratTuning().factorEratSmall == config::FACTOR_ERATSMALL &&
+        getEratTuning().factorEratMedium == config::FACTOR_ERATMEDIUM);
+
+  // { factorEratSmall, factorEratMedium }
+  const Array<Array<double, 2>, 6> factors =
+  {{
+    { 0.2, 3.0 },
+    { 0.01, 0.01 },
+    { 4.5, 0.01 },
+    { 4.5, 4.5 },
+    { 0.01, 4.5 },
+    { 1.0, 0.5 }
+  }};
+
+  for (const auto& f : factors)
+  {
+    setEratTuning(f[0], f[1]);
+    std::cout << "factorEratSmall = " << f[0] << ", factorEratMedium = " << f[1] << std::endl;
+
+    set_sieve_size(16);
+    uint64_t count = count_primes(0, (uint64_t) 1e8);
+    std::cout << "Prime count [0, 10^8]: " << count;
+    check(count == 5761455);
+
+    count = count_primes((uint64_t) 1e12, (uint64_t) 1e12 + (uint64_t) 1e8);
+    std::cout << "Prime count [10^12, 10^12+10^8]: " << count;
+    check(count == 3618282);
+
+    set_sieve_size(1024);
+    count = count_primes((uint64_t) 1e15, (uint64_t) 1e15 + (uint64_t) 1e8);
+    std::cout << "Prime count [10^15, 10^15+10^8]: " << count;
+    check(count == 2893937);
+  }
+
+  for (double f : { 0.0, -1.0, 4.6 })
+  {
+    try
+    {
+      setEratTuning(f, 1.0);
+      std::cerr << "ERROR: setEratTuning(" << f << ", 1.0) did not throw" << std::endl;
+      std::exit(1);
+    }
+    catch (const primesieve_error& e)
+    {
+      std::cout << "OK: " << e.what() << std::endl;
+    }
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
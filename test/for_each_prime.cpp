@@ -0,0 +1,98 @@
+///
+/// @file   for_each_prime.cpp
+/// @brief  Test for_each_prime(), for_each_prime_block() and
+///         parallel_for_each_prime_block().
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  uint64_t sum = 0;
+  for_each_prime(0, 1000000000, [&](uint64_t prime) { sum += prime; });
+  std::cout << "Sum of the primes <= 10^9: " << sum;
+  check(sum == 24739512092254535ull);
+
+  uint64_t count = 0;
+  uint64_t prev = 0;
+  bool ascending = true;
+
+  for_each_prime_block(123456789, 987654321,
+    [&](const uint64_t* primes, std::size_t size)
+    {
+      for (std::size_t i = 0; i < size; i++)
+      {
+        ascending &= (primes[i] > prev);
+        prev = primes[i];
+      }
+      count += size;
+    });
+
+  std::cout << "Count of the primes inside [123456789, 987654321]: " << count;
+  check(count == count_primes(123456789, 987654321));
+  std::cout << "Primes are in ascending order";
+  check(ascending);
+
+  std::vector<uint64_t> primes;
+  uint64_t start = 18446744073709550000ull;
+  uint64_t stop = 18446744073709551615ull;
+  for_each_prime(start, stop, [&](uint64_t prime) { primes.push_back(prime); });
+  std::cout << "Count of the primes inside [" << start << ", " << stop << "]: " << primes.size();
+  check(primes.size() == count_primes(start, stop) && primes.back() == 18446744073709551557ull);
+
+  primes.clear();
+  for_each_prime(1000, 10, [&](uint64_t prime) { primes.push_back(prime); });
+  std::cout << "Count of the primes inside [1000, 10]: " << primes.size();
+  check(primes.empty());
+
+  set_num_threads(4);
+  std::vector<uint64_t> sums(get_num_threads(), 0);
+  std::vector<uint64_t> counts(get_num_threads(), 0);
+
+  parallel_for_each_prime_block(0, 1000000000,
+    [&](const uint64_t* block, std::size_t size, int thread)
+    {
+      for (std::size_t i = 0; i < size; i++)
+        sums[thread] += block[i];
+      counts[thread] += size;
+    });
+
+  sum = 0;
+  count = 0;
+
+  for (std::size_t i = 0; i < sums.size(); i++)
+  {
+    sum += sums[i];
+    count += counts[i];
+  }
+
+  std::cout << "Sum of the primes <= 10^9: " << sum;
+  check(sum == 24739512092254535ull);
+  std::cout << "Count of the primes <= 10^9: " << count;
+  check(count == 50847534);
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+///
+/// @file   for_each_segment.cpp
+/// @brief  Test for_each_segment() and parallel_for_each_segment().
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace primesieve;
+
+const uint64_t bitValues[8] = { 7, 11, 13, 17, 19, 23, 29, 31 };
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+/// Number of primes < 7 inside [start, stop]
+uint64_t smallPrimes(uint64_t start, uint64_t stop)
+{
+  uint64_t count = 0;
+  for (uint64_t p : { 2, 3, 5 })
+    count += (p >= start && p <= stop);
+  return count;
+}
+
+void decode(std::vector<uint64_t>& primes,
+            const uint8_t* sieve,
+            std::size_t size,
+            uint64_t low)
+{
+  for (std::size_t i = 0; i < size; i++)
+    for (int j = 0; j < 8; j++)
+      if (sieve[i] & (1 << j))
+        primes.push_back(low + i * 30 + bitValues[j]);
+}
+
+void test(uint64_t start, uint64_t stop)
+{
+  std::vector<uint64_t> primes;
+  bool padding = true;
+
+  for_each_segment(start, stop,
+    [&](const uint8_t* sieve, std::size_t size, uint64_t low)
+    {
+      decode(primes, sieve, size, low);
+      for (std::size_t i = size; i % 8 != 0; i++)
+        padding &= (sieve[i] == 0);
+    });
+
+  std::vector<uint64_t> primes2;
+  generate_primes(std::max<uint64_t>(start, 7), stop, &primes2);
+
+  std::cout << "for_each_segment(" << start << ", " << stop << ") primes: " << primes.size();
+  check(primes == primes2);
+  std::cout << "Padding bytes are zero";
+  check(padding);
+}
+
+void testParallel(uint64_t start, uint64_t stop)
+{
+  std::vector<uint64_t> counts(get_num_threads(), 0);
+
+  parallel_for_each_segment(start, stop,
+    [&](const uint8_t* sieve, std::size_t size, uint64_t, int thread)
+    {
+      for (std::size_t i = 0; i < size; i++)
+        for (unsigned bits = sieve[i]; bits != 0; bits &= bits - 1)
+          counts[thread]++;
+    });
+
+  uint64_t count = smallPrimes(start, stop);
+  for (uint64_t c : counts)
+    count += c;
+
+  std::cout << "parallel_for_each_segment(" << start << ", " << stop << ") primes: " << count;
+  check(count == count_primes(start, stop));
+}
+
+int main()
+{
+  test(0, 0);
+  test(0, 100);
+  test(7, 7);
+  test(8, 10);
+  test(100, 1000000);
+  test(1000000000000ull, 1000001000000ull);
+  test(18446744073709550000ull, 18446744073709551615ull);
+
+  set_num_threads(4);
+  testParallel(0, 1000000000);
+  testParallel(999999999, 1234567890);
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+///
+/// @file   generate_primes3.cpp
+/// @brief  Test multi-threaded prime number generation
+///         of large intervals.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+template <typename T>
+void test(uint64_t start, uint64_t stop)
+{
+  std::vector<T> primes;
+  primes.push_back(7);
+  generate_primes(start, stop, &primes);
+
+  std::cout << "generate_primes(" << start << ", " << stop << ").size() = " << primes.size() - 1;
+  check(primes.size() - 1 == count_primes(start, stop));
+
+  primesieve::iterator it(start, stop);
+  bool OK = (primes[0] == 7);
+
+  for (std::size_t i = 1; i < primes.size(); i++)
+    OK &= (primes[i] == (T) it.next_prime());
+
+  std::cout << "Primes match primesieve::iterator";
+  check(OK);
+}
+
+int main()
+{
+  set_num_threads(4);
+
+  test<uint64_t>(0, 100000000);
+  test<uint64_t>(123456789, 223456789);
+  test<int32_t>(1000000000, 1100000000);
+  test<uint32_t>(4200000000u, 4294967295u);
+  test<int64_t>(1000000000000ull, 1000100000000ull);
+  test<uint64_t>(18446744073689551615ull, 18446744073709551615ull);
+
+  // The last chunk [70008303, 70008413] is tiny and
+  // contains more primes than prime_count_upper().
+  test<uint64_t>(8130, 70008413);
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+///
+/// @file   get_shard.cpp
+/// @brief  Split intervals into shards using get_shard() and
+///         check that the shards are disjoint, cover the
+///         interval and never split prime k-tuplets.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+/// Returns true if the shards are disjoint,
+/// in ascending order and cover [start, stop].
+///
+bool checkShards(uint64_t start, uint64_t stop, uint64_t n)
+{
+  uint64_t next = start;
+  bool isEnd = false;
+
+  for (uint64_t i = 0; i < n; i++)
+  {
+    auto shard = get_shard(start, stop, i, n);
+
+    // Empty shards are at the end
+    if (shard.first > shard.second)
+    {
+      isEnd = true;
+      continue;
+    }
+
+    if (isEnd || shard.first != next || shard.second > stop)
+      return false;
+
+    if (shard.second == stop)
+      isEnd = true;
+    else
+      next = shard.second + 1;
+  }
+
+  return isEnd;
+}
+
+int main()
+{
+  uint64_t max = std::numeric_limits<uint64_t>::max();
+  std::pair<uint64_t, uint64_t> intervals[] =
+  {
+    { 0, 0 }, { 0, 100 }, { 7, 7 }, { 10, 20 }, { 1000, 1000000 },
+    { (uint64_t) 1e12, (uint64_t) 1e12 + (uint64_t) 1e9 },
+    { max - (uint64_t) 1e6, max }, { 0, max }
+  };
+
+  for (auto interval : intervals)
+  {
+    for (uint64_t n : { 1, 2, 3, 7, 64, 1000 })
+    {
+      std::cout << "Shards of [" << interval.first << ", " << interval.second << "], n = " << n;
+      check(checkShards(interval.first, interval.second, n));
+    }
+  }
+
+  // Prime k-tuplets must not be split between shards
+  uint64_t start = (uint64_t) 1e12;
+  uint64_t stop = start + (uint64_t) 2e8;
+
+  for (uint64_t n : { 3, 17, 100 })
+  {
+    uint64_t primes = 0;
+    uint64_t twins = 0;
+    uint64_t sextuplets = 0;
+
+    for (uint64_t i = 0; i < n; i++)
+    {
+      auto shard = get_shard(start, stop, i, n);
+      primes += count_primes(shard.first, shard.second);
+      twins += count_twins(shard.first, shard.second);
+      sextuplets += count_sextuplets(shard.first, shard.second);
+    }
+
+    std::cout << "Sum of " << n << " shards PrimePi(" << start << ", " << stop << ") = " << primes;
+    check(primes == count_primes(start, stop));
+    std::cout << "Sum of " << n << " shards Twins(" << start << ", " << stop << ") = " << twins;
+    check(twins == count_twins(start, stop));
+    std::cout << "Sum of " << n << " shards Sextuplets(" << start << ", " << stop << ") = " << sextuplets;
+    check(sextuplets == count_sextuplets(start, stop));
+  }
+
+  try
+  {
+    get_shard(0, 100, 5, 5);
+    std::cout << "get_shard(0, 100, 5, 5)";
+    check(false);
+  }
+  catch (const primesieve_error& e)
+  {
+    std::cout << "get_shard(0, 100, 5, 5): " << e.what();
+    check(true);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+///
+/// @file   huge_pages.cpp
+/// @brief  Count primes using huge pages for the sieve arrays
+///         and the MemoryPool's buckets. If huge pages are
+///         not available the default allocator is used.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/HugePages.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  HugePageAllocator<uint64_t> allocator;
+  std::size_t n = (4 << 20) / sizeof(uint64_t) + 3;
+
+  set_huge_pages(true);
+  uint64_t* array = allocator.allocate(n);
+  for (std::size_t i = 0; i < n; i++)
+    array[i] = i;
+  uint64_t sum = 0;
+  for (std::size_t i = 0; i < n; i++)
+    sum += array[i];
+  set_huge_pages(false);
+  allocator.deallocate(array, n);
+  std::cout << "HugePageAllocator sum = " << sum;
+  check(sum == (uint64_t) n * (n - 1) / 2);
+
+  // Sieve intervals that use EratBig, with a
+  // small and a large (huge page) sieve size.
+  uint64_t starts[] = { (uint64_t) 1e15, (uint64_t) 1e18 };
+  uint64_t dist = (uint64_t) 3e7;
+  int sieveSizes[] = { 32, 4096 };
+
+  for (uint64_t start : starts)
+  {
+    for (int sieveSize : sieveSizes)
+    {
+      uint64_t stop = start + dist;
+      set_sieve_size(sieveSize);
+      set_huge_pages(false);
+      uint64_t count1 = count_primes(start, stop);
+      uint64_t twins1 = count_twins(start, stop);
+      set_huge_pages(true);
+      uint64_t count2 = count_primes(start, stop);
+      uint64_t twins2 = count_twins(start, stop);
+      std::cout << "PrimePi(" << start << ", " << stop << ") = " << count2;
+      check(count1 == count2);
+      std::cout << "Twins(" << start << ", " << stop << ") = " << twins2;
+      check(twins1 == twins2);
+    }
+  }
+
+  // Iterate over primes with huge pages enabled
+  iterator it((uint64_t) 1e17);
+  uint64_t prime = it.next_prime();
+  uint64_t count = 0;
+  for (; prime < (uint64_t) 1e17 + (uint64_t) 1e7; prime = it.next_prime())
+    count++;
+  std::cout << "iterator count = " << count;
+  check(count == count_primes((uint64_t) 1e17, (uint64_t) 1e17 + (uint64_t) 1e7));
+
+  set_huge_pages(false);
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+///
+/// @file   next_primes1.cpp
+/// @brief  Test iterator::next_primes(), next_prime_block()
+///         and set_batch_size().
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  std::vector<uint64_t> primes;
+  primesieve::generate_primes(1000000000, 1010000000, &primes);
+
+  for (std::size_t batchSize : { 1, 64, 1000, 1 << 14 })
+  {
+    for (std::size_t n : { 1, 7, 1000, 4096, 100000 })
+    {
+      primesieve::iterator it(primes.front());
+      it.set_batch_size(batchSize);
+      std::vector<uint64_t> buffer(n);
+      std::size_t i = 0;
+      bool OK = true;
+
+      // Mix next_primes(), next_prime() and next_prime_block()
+      while (i + n <= primes.size())
+      {
+        it.next_primes(buffer.data(), n);
+        for (std::size_t j = 0; j < n; j++)
+          OK &= buffer[j] == primes[i++];
+
+        if (i < primes.size())
+          OK &= it.next_prime() == primes[i++];
+
+        std::size_t size;
+        const uint64_t* block = it.next_prime_block(&size);
+        OK &= size > 0;
+        for (std::size_t j = 0; j < size && i < primes.size(); j++)
+          OK &= block[j] == primes[i++];
+      }
+
+      std::cout << "next_primes(buffer, " << n << ") with batch size " << batchSize;
+      check(OK);
+    }
+  }
+
+  // next_prime_block() is a span over the primes array
+  primesieve::iterator it(primes.front());
+  it.set_batch_size(1 << 14);
+  std::size_t size;
+  std::size_t maxSize = 0;
+  std::size_t i = 0;
+  bool OK = true;
+
+  // The sieving distance increases after each
+  // segment, hence the later blocks are larger.
+  for (int j = 0; j < 10; j++)
+  {
+    const uint64_t* block = it.next_prime_block(&size);
+    maxSize = std::max(maxSize, size);
+    for (std::size_t k = 0; k < size; k++)
+      OK &= block[k] == primes[i++];
+  }
+
+  std::cout << "next_prime_block(&size) max size = " << maxSize;
+  check(OK && maxSize > 4096 && maxSize <= (1 << 14) + 64);
+
+  // next_prime_block() followed by prev_prime()
+  it.jump_to(100);
+  const uint64_t* block = it.next_prime_block(&size);
+  uint64_t last = block[size - 1];
+  std::cout << "prev_prime() after next_prime_block() = " << it.prev_prime();
+  check(size > 1 && it.prev_prime() < last && it.next_prime() == block[size - 2]);
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+///
+/// @file   next_primes2.c
+/// @brief  Test primesieve_next_primes(),
+///         primesieve_next_prime_block() and
+///         primesieve_set_batch_size().
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void check(int OK)
+{
+  if (OK)
+    printf("   OK\n");
+  else
+  {
+    printf("   ERROR\n");
+    exit(1);
+  }
+}
+
+int main(void)
+{
+  size_t size = 0;
+  uint64_t* primes = (uint64_t*) primesieve_generate_primes(0, 10000000, &size, UINT64_PRIMES);
+  size_t batch_sizes[3] = { 10, 1000, 16384 };
+  size_t ns[3] = { 1, 999, 8192 };
+  size_t b, k, i, j;
+
+  for (b = 0; b < 3; b++)
+  {
+    for (k = 0; k < 3; k++)
+    {
+      size_t n = ns[k];
+      uint64_t* buffer = (uint64_t*) malloc(n * sizeof(uint64_t));
+      primesieve_iterator it;
+      primesieve_init(&it);
+      primesieve_set_batch_size(&it, batch_sizes[b]);
+      int OK = 1;
+      i = 0;
+
+      while (i + n <= size)
+      {
+        const uint64_t* block;
+        size_t block_size;
+
+        primesieve_next_primes(&it, buffer, n);
+        for (j = 0; j < n; j++)
+          OK &= buffer[j] == primes[i++];
+
+        if (i < size)
+          OK &= primesieve_next_prime(&it) == primes[i++];
+
+        block = primesieve_next_prime_block(&it, &block_size);
+        OK &= block_size > 0;
+        for (j = 0; j < block_size && i < size; j++)
+          OK &= block[j] == primes[i++];
+      }
+
+      printf("primesieve_next_primes(&it, buffer, %zu) with batch size %zu", n, batch_sizes[b]);
+      check(OK && !it.is_error);
+      primesieve_free_iterator(&it);
+      free(buffer);
+    }
+  }
+
+  primesieve_iterator it;
+  primesieve_init(&it);
+  primesieve_jump_to(&it, 18446744073709551557ull, UINT64_MAX);
+  uint64_t buffer[3];
+  primesieve_next_primes(&it, buffer, 3);
+  printf("primesieve_next_primes(18446744073709551557, 3) = %" PRIu64 ", %" PRIu64, buffer[0], buffer[1]);
+  check(buffer[0] == 18446744073709551557ull &&
+        buffer[1] == PRIMESIEVE_ERROR &&
+        buffer[2] == PRIMESIEVE_ERROR &&
+        it.is_error);
+
+  primesieve_free_iterator(&it);
+  primesieve_free(primes);
+
+  printf("\n");
+  printf("All tests passed successfully!\n");
+
+  return 0;
+}
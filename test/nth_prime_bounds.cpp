@@ -0,0 +1,162 @@
+///
+/// @file   nth_prime_bounds.cpp
+/// @brief  Test the lower and upper bounds of PrimePi(x) and
+///         of the nth prime and compare nth_prime(n, start)
+///         using a prime count index with nth_prime(n, start)
+///         without index.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/PrimePiIndex.hpp>
+#include <primesieve/RiemannR.hpp>
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+// PrimePi(10^i) for i = 1, 2, ..., 19
+const std::vector<uint64_t> pi_table =
+{
+  4ull, 25ull, 168ull, 1229ull, 9592ull, 78498ull, 664579ull,
+  5761455ull, 50847534ull, 455052511ull, 4118054813ull,
+  37607912018ull, 346065536839ull, 3204941750802ull,
+  29844570422669ull, 279238341033925ull, 2623557157654233ull,
+  24739954287740860ull, 234057667276344607ull
+};
+
+// nth prime for n = 10^i with i = 1, 2, ..., 18
+const std::vector<uint64_t> nth_prime_table =
+{
+  29ull, 541ull, 7919ull, 104729ull, 1299709ull, 15485863ull,
+  179424673ull, 2038074743ull, 22801763489ull, 252097800623ull,
+  2760727302517ull, 29996224275833ull, 323780508946331ull,
+  3475385758524527ull, 37124508045065437ull, 394906913903735329ull,
+  4185296581467695669ull
+};
+
+int main()
+{
+  uint64_t x = 1;
+
+  for (uint64_t pix : pi_table)
+  {
+    x *= 10;
+    std::cout << "primePiLower(" << x << ") <= " << pix << " <= primePiUpper(" << x << ")";
+    check(primePiLower(x) <= pix && pix <= primePiUpper(x));
+  }
+
+  uint64_t n = 1;
+
+  for (uint64_t prime : nth_prime_table)
+  {
+    n *= 10;
+    std::cout << "nthPrimeLower(" << n << ") <= " << prime << " <= nthPrimeUpper(" << n << ")";
+    check(nthPrimeLower(n) <= prime && prime <= nthPrimeUpper(n));
+  }
+
+  // Compare the bounds with the exact PrimePi(x)
+  primesieve::iterator it;
+  uint64_t prime = it.next_prime();
+  uint64_t pix = 0;
+  bool OK = true;
+
+  for (x = 0; x <= 3000000; x++)
+  {
+    if (x == prime)
+    {
+      pix++;
+      if (pix % 13 == 0)
+      {
+        OK &= nthPrimeLower(pix) <= prime;
+        OK &= nthPrimeUpper(pix) >= prime;
+      }
+      prime = it.next_prime();
+    }
+
+    if (x % 7 == 0)
+    {
+      OK &= primePiLower(x) <= pix;
+      OK &= primePiUpper(x) >= pix;
+    }
+  }
+
+  std::cout << "Bounds of PrimePi(x) and nth prime <= 3000000";
+  check(OK);
+
+  std::string filename = "nth_prime_bounds_test.idx";
+  uint64_t stride = 10000019;
+  uint64_t stop = (uint64_t) 2e9;
+
+  PrimePiIndex index;
+  index.build(stop, stride);
+  index.save(filename);
+
+  std::vector<uint64_t> starts = { 0, 123456789, 1999999999 };
+  std::vector<int64_t> ns = { 1, 1000, 20000000, 60000000 };
+  std::vector<uint64_t> primes;
+
+  for (uint64_t start : starts)
+  {
+    uint64_t pi = index.countPrimes(0, start);
+    for (int64_t i : ns)
+      for (int64_t j : { i, -i })
+        if (j > 0 || (uint64_t) -j <= pi / 2)
+          primes.push_back(nth_prime(j, start));
+  }
+
+  set_pi_index(filename);
+  std::size_t k = 0;
+
+  for (uint64_t start : starts)
+  {
+    uint64_t pi = index.countPrimes(0, start);
+    for (int64_t i : ns)
+    {
+      for (int64_t j : { i, -i })
+      {
+        if (j > 0 || (uint64_t) -j <= pi / 2)
+        {
+          std::cout << "Pi index nth_prime(" << j << ", " << start << ") = " << nth_prime(j, start);
+          check(nth_prime(j, start) == primes[k++]);
+        }
+      }
+    }
+  }
+
+  try
+  {
+    nth_prime(-100000000, stop);
+    std::cout << "Pi index nth_prime(-100000000, " << stop << ")";
+    check(false);
+  }
+  catch (const primesieve_error& e)
+  {
+    std::cout << "Pi index nth_prime(-100000000, " << stop << "): " << e.what();
+    check(true);
+  }
+
+  set_pi_index("");
+  std::remove(filename.c_str());
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+///
+/// @file   nth_prime_select.cpp
+/// @brief  nth_prime(n, start) locates the nth prime inside the
+///         sieve array using select64(). Compare select64()
+///         with a naive implementation and nth_prime(n, start)
+///         with the primes generated by primesieve::iterator.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/intrinsics.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+uint64_t naiveSelect64(uint64_t x, uint64_t n)
+{
+  for (uint64_t i = 0; i < 64; i++)
+    if (((x >> i) & 1) && n-- == 0)
+      return i;
+
+  return 64;
+}
+
+int main()
+{
+  uint64_t x = 0x9E3779B97F4A7C15ull;
+  bool OK = true;
+
+  for (int i = 0; i < 100000; i++)
+  {
+    // xorshift64
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    uint64_t bits = x & (x >> (i % 64));
+    if (i % 1000 == 0)
+      bits = ~0ull;
+
+    for (uint64_t n = 0; n < (uint64_t) popcnt64(bits); n++)
+      OK &= select64(bits, n) == naiveSelect64(bits, n);
+  }
+
+  std::cout << "select64(x, n) == naiveSelect64(x, n)";
+  check(OK);
+
+  for (uint64_t start : { 0ull, 100ull, 1000000007ull, 1000000000000ull })
+  {
+    std::vector<uint64_t> primes;
+    primesieve::iterator it(start);
+    for (int i = 0; i < 5000; i++)
+      primes.push_back(it.next_prime());
+
+    // nth_prime(n, start) returns the nth prime > start
+    uint64_t offset = (primes[0] == start) ? 1 : 0;
+    OK = true;
+
+    for (uint64_t n = 1; n + offset <= primes.size(); n += 7)
+      OK &= nth_prime(n, start) == primes[n + offset - 1];
+
+    std::cout << "nth_prime(n, " << start << ")";
+    check(OK);
+  }
+
+  for (uint64_t start : { 100000ull, 1000000007ull, 1000000000000ull })
+  {
+    std::vector<uint64_t> primes;
+    primesieve::iterator it(start);
+    for (int i = 0; i < 5000 && (primes.empty() || primes.back() > 2); i++)
+      primes.push_back(it.prev_prime());
+
+    // nth_prime(-n, start) returns the nth prime < start
+    uint64_t offset = (primes[0] == start) ? 1 : 0;
+    OK = true;
+
+    for (uint64_t n = 1; n + offset <= primes.size(); n += 7)
+      OK &= nth_prime(-(int64_t) n, start) == primes[n + offset - 1];
+
+    std::cout << "nth_prime(-n, " << start << ")";
+    check(OK);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+///
+/// @file   nth_primes.cpp
+/// @brief  Compare nth_primes(n, start) with nth_prime(n, start).
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+
+#include <stdint.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+void test(const std::vector<int64_t>& n, uint64_t start)
+{
+  std::vector<uint64_t> primes = nth_primes(n, start);
+  bool OK = primes.size() == n.size();
+
+  for (std::size_t i = 0; OK && i < n.size(); i++)
+    OK = primes[i] == nth_prime(n[i], start);
+
+  std::cout << "nth_primes(" << n.size() << " n, " << start << ")";
+  check(OK);
+}
+
+int main()
+{
+  test({}, 0);
+  test({ 0, 1, 2, 3, 4, 5, 6, 25 }, 0);
+  test({ 1, 2, 3 }, 1);
+  test({ -1, -2, -3, -4, 1, 2 }, 8);
+
+  // Unsorted, duplicates and mixed signs
+  std::vector<int64_t> n;
+  uint64_t x = 1;
+
+  for (int i = 0; i < 100; i++)
+  {
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+    int64_t m = (int64_t) ((x >> 33) % 2000000) + 1;
+    n.push_back((i % 3 == 0) ? -m : m);
+  }
+
+  n.push_back(n[0]);
+  n.push_back(0);
+  test(n, 100000000);
+  test(n, 1000000000000ull);
+
+  n.clear();
+  for (int64_t i = 1; i <= 10; i++)
+    n.push_back(i * 1000000);
+
+  test(n, 0);
+
+  // The nth primes are far from start, they are
+  // located using the bounds of the nth prime.
+  test({ 3000000000ll, 10, 1, 3000000000ll, 3000001000ll, 2000000000ll }, 0);
+  test({ 1000000000ll, -1000000000ll, -10, 10, 5000000000ll }, 1000000000000ull);
+
+  // One large n must not be slower than nth_prime(n),
+  // i.e. nth_primes() must not sieve up to the nth prime.
+  auto t1 = std::chrono::steady_clock::now();
+  uint64_t prime = nth_prime(3000000000ll);
+  auto t2 = std::chrono::steady_clock::now();
+  std::vector<uint64_t> primes = nth_primes({ 3000000000ll });
+  auto t3 = std::chrono::steady_clock::now();
+  std::chrono::duration<double> seconds1 = t2 - t1;
+  std::chrono::duration<double> seconds2 = t3 - t2;
+
+  std::cout << "nth_primes({ 3000000000 }) = " << primes[0] << ", "
+            << seconds2.count() << " sec (nth_prime: " << seconds1.count() << " sec)";
+  check(primes[0] == prime &&
+        primes[0] == 71856445751ull &&
+        seconds2.count() <= seconds1.count() * 5 + 1);
+
+  try
+  {
+    nth_primes({ 10, -10 }, 5);
+    std::cout << "nth_primes({ 10, -10 }, 5)";
+    check(false);
+  }
+  catch (const primesieve_error& e)
+  {
+    std::cout << "nth_primes({ 10, -10 }, 5): " << e.what();
+    check(true);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+///
+/// @file   pi_index.cpp
+/// @brief  Build a prime count index, save it to a file and
+///         count primes using the index.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/PrimePiIndex.hpp>
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  std::string filename = "pi_index_test.idx";
+  uint64_t stride = 1000003;
+  uint64_t stop = (uint64_t) 3e8;
+
+  // Build the index in 2 steps
+  PrimePiIndex index;
+  index.build(stop / 2, stride);
+  index.build(stop, stride);
+  index.save(filename);
+
+  std::cout << "Index stop = " << index.getStop();
+  check(index.getStop() == stop - stop % stride);
+
+  for (uint64_t i = 0; i * stride <= stop; i += 37)
+  {
+    uint64_t x = i * stride;
+    std::cout << "PrimePi(" << x << ") = " << index.countPrimes(0, x);
+    check(index.countPrimes(0, x) == count_primes(0, x));
+  }
+
+  PrimePiIndex index2;
+  index2.load(filename);
+  std::cout << "Load index";
+  check(index2.getStop() == index.getStop() &&
+        index2.getStride() == stride);
+
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<uint64_t> dist(0, stop + stop / 4);
+
+  for (int i = 0; i < 100; i++)
+  {
+    uint64_t start = dist(gen);
+    uint64_t stop2 = dist(gen);
+    uint64_t count = count_primes(start, stop2);
+    std::cout << "PrimePi(" << start << ", " << stop2 << ") = " << count;
+    check(index2.countPrimes(start, stop2) == count);
+  }
+
+  // count_primes() uses the index
+  uint64_t count = count_primes(12345, stop - 6789);
+  set_pi_index(filename);
+  std::cout << "count_primes() using index = " << count;
+  check(count_primes(12345, stop - 6789) == count);
+
+  // nth_primes() uses the index
+  std::vector<int64_t> n = { 1000000, 15000000, 10, -10, -5000000 };
+  std::vector<uint64_t> primes = nth_primes(n, 100000000);
+  set_pi_index("");
+  std::cout << "nth_primes() using index = " << primes[1];
+  check(primes == nth_primes(n, 100000000));
+
+  // Invalid index files must be rejected
+  std::FILE* file = std::fopen(filename.c_str(), "r+b");
+  std::fseek(file, 100, SEEK_SET);
+  std::fputc(0xff, file);
+  std::fclose(file);
+
+  try
+  {
+    index2.load(filename);
+    std::cout << "Load corrupt index";
+    check(false);
+  }
+  catch (const primesieve_error& e)
+  {
+    std::cout << "Load corrupt index: " << e.what();
+    check(true);
+  }
+
+  std::remove(filename.c_str());
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+///
+/// @file   pin_threads.cpp
+/// @brief  Check that the worker threads are pinned to distinct
+///         CPU cores (spread across the NUMA nodes) and run on
+///         them, and that unpinning restores their affinity.
+///         Also count primes with and without pinning.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/CpuInfo.hpp>
+#include <primesieve/ThreadPool.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && \
+    __has_include(<pthread.h>) && \
+    __has_include(<sched.h>)
+  #include <pthread.h>
+  #include <sched.h>
+  #define HAS_PTHREAD_AFFINITY
+#endif
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+#if defined(HAS_PTHREAD_AFFINITY)
+
+std::vector<int> getAffinity()
+{
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  std::vector<int> res;
+
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0)
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+      if (CPU_ISSET(cpu, &cpus))
+        res.push_back(cpu);
+
+  return res;
+}
+
+struct Worker
+{
+  std::vector<int> affinity;
+  int cpu;
+};
+
+/// Run tasks on the thread pool and record the affinity
+/// and the current CPU of each worker thread.
+///
+std::map<std::thread::id, Worker> getWorkers()
+{
+  std::map<std::thread::id, Worker> workers;
+  std::thread::id caller = std::this_thread::get_id();
+  std::mutex mutex;
+
+  ThreadPool::get().run(64, [&](int)
+  {
+    // Give the other worker threads time to pick up a task
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    std::vector<int> affinity = getAffinity();
+    int cpu = sched_getcpu();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (std::this_thread::get_id() != caller)
+      workers[std::this_thread::get_id()] = { affinity, cpu };
+  });
+
+  return workers;
+}
+
+void testAffinity()
+{
+  std::vector<int> allowed = getAffinity();
+
+  set_pin_threads(true);
+  auto workers = getWorkers();
+  std::cout << "Pinned worker threads: " << workers.size() << "\n";
+
+  std::vector<int> pinned;
+  for (auto& w : workers)
+  {
+    const Worker& worker = w.second;
+    bool OK = worker.affinity.size() == 1 &&
+              worker.cpu == worker.affinity[0] &&
+              std::count(allowed.begin(), allowed.end(), worker.cpu);
+
+    std::cout << "Worker thread pinned to CPU " << (worker.affinity.empty() ? -1 : worker.affinity[0])
+              << ", runs on CPU " << worker.cpu;
+    check(OK);
+    pinned.push_back(worker.cpu);
+  }
+
+  // If there are fewer worker threads than CPU
+  // cores each worker has its own CPU core.
+  std::sort(pinned.begin(), pinned.end());
+  if (pinned.size() < allowed.size())
+  {
+    std::cout << "Worker threads use distinct CPU cores";
+    check(std::unique(pinned.begin(), pinned.end()) == pinned.end());
+  }
+
+  // The workers take turns across the NUMA nodes,
+  // hence the nodes differ by at most 1 worker.
+  std::size_t nodes = cpuInfo.numaNodes();
+  if (nodes > 1)
+  {
+    std::vector<std::size_t> perNode(nodes, 0);
+    for (int cpu : pinned)
+      for (std::size_t node = 0; node < nodes; node++)
+      {
+        const auto& cpus = cpuInfo.numaNodeCpus(node);
+        if (std::count(cpus.begin(), cpus.end(), (std::size_t) cpu))
+          perNode[node]++;
+      }
+
+    auto minMax = std::minmax_element(perNode.begin(), perNode.end());
+    std::cout << "Worker threads per NUMA node: " << *minMax.first << " - " << *minMax.second;
+    check(*minMax.second - *minMax.first <= 1);
+  }
+
+  // The thread calling run() is not pinned
+  std::cout << "Calling thread affinity unchanged";
+  check(getAffinity() == allowed);
+
+  set_pin_threads(false);
+  workers = getWorkers();
+
+  for (auto& w : workers)
+  {
+    std::cout << "Unpinned worker thread, allowed CPUs: " << w.second.affinity.size();
+    check(w.second.affinity == allowed);
+  }
+}
+
+#endif
+
+int main()
+{
+#if defined(HAS_PTHREAD_AFFINITY)
+  testAffinity();
+#endif
+
+  uint64_t start = (uint64_t) 1e12;
+  uint64_t stop = start + (uint64_t) 1e9;
+  uint64_t count = count_primes(start, stop);
+
+  for (bool pin : { true, false, true, false })
+  {
+    set_pin_threads(pin);
+    std::cout << "PinThreads = " << pin << ", PrimePi(" << start << ", " << stop << ") = " << count;
+    check(count_primes(start, stop) == count);
+    std::cout << "PinThreads = " << pin << ", Twins(1e9)";
+    check(count_twins(0, (uint64_t) 1e9) == 3424506);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
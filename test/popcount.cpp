@@ -0,0 +1,99 @@
+///
+/// @file   popcount.cpp
+/// @brief  Compare each popcount() kernel (default, AVX2,
+///         AVX512) with a simple scalar popcount.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve/forward.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+uint64_t popcountScalar(const uint64_t* array, uint64_t size)
+{
+  uint64_t cnt = 0;
+
+  for (uint64_t i = 0; i < size; i++)
+    for (uint64_t bits = array[i]; bits != 0; bits &= bits - 1)
+      cnt++;
+
+  return cnt;
+}
+
+int main()
+{
+  const char* names[] = { "default", "AVX2", "AVX512" };
+  PopcountKernel kernels[] = { POPCOUNT_DEFAULT, POPCOUNT_AVX2, POPCOUNT_AVX512 };
+  std::vector<uint64_t> array(1000);
+  uint64_t seed = 1;
+
+  // Random words, with runs of all 0 and all 1 bits
+  for (std::size_t i = 0; i < array.size(); i++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    if (i % 100 < 10)
+      array[i] = 0;
+    else if (i % 100 < 20)
+      array[i] = ~0ull;
+    else
+      array[i] = seed ^ (seed >> 29);
+  }
+
+  for (int k = 0; k < 3; k++)
+  {
+    uint64_t count;
+
+    if (!popcount(array.data(), 0, kernels[k], count))
+    {
+      std::cout << "popcount " << names[k] << " kernel not supported by CPU\n";
+      continue;
+    }
+
+    // All lengths 0 - 700 (odd lengths and all tails
+    // shorter than one vector block), at different
+    // (unaligned) offsets.
+    bool OK = true;
+
+    for (std::size_t offset = 0; offset < 4; offset++)
+    {
+      for (std::size_t size = 0; size <= 700; size++)
+      {
+        const uint64_t* ptr = &array[offset];
+        OK &= popcount(ptr, size, kernels[k], count);
+        OK &= count == popcountScalar(ptr, size);
+      }
+    }
+
+    std::cout << "popcount " << names[k] << " kernel, size = 0 - 700";
+    check(OK);
+
+    OK = popcount(array.data(), array.size(), kernels[k], count);
+    std::cout << "popcount " << names[k] << " kernel, size = " << array.size() << ": " << count;
+    check(OK && count == popcountScalar(array.data(), array.size()));
+  }
+
+  uint64_t count = popcount(array.data(), array.size());
+  std::cout << "popcount(array, " << array.size() << ") = " << count;
+  check(count == popcountScalar(array.data(), array.size()));
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
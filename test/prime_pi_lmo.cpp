@@ -0,0 +1,88 @@
+///
+/// @file   prime_pi_lmo.cpp
+/// @brief  Compare primePiLMO(x) with known values of PrimePi(x)
+///         and with count_primes(start, stop) computed by sieving.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PrimePiLMO.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+/// Count the primes inside [start, stop] by sieving
+uint64_t sieveCount(uint64_t start, uint64_t stop)
+{
+  // LMO is only used if COUNT_PRIMES is the only flag
+  ParallelSieve ps;
+  ps.sieve(start, stop, COUNT_PRIMES | COUNT_TWINS);
+  return ps.getCount(0);
+}
+
+// PrimePi(10^i) for i = 1, 2, ..., 13
+const std::vector<uint64_t> pi_table =
+{
+  4ull, 25ull, 168ull, 1229ull, 9592ull, 78498ull, 664579ull,
+  5761455ull, 50847534ull, 455052511ull, 4118054813ull,
+  37607912018ull, 346065536839ull
+};
+
+int main()
+{
+  uint64_t x = 1;
+  int threads = get_num_threads();
+
+  for (uint64_t pix : pi_table)
+  {
+    x *= 10;
+    uint64_t res = primePiLMO(x, threads);
+    std::cout << "primePiLMO(" << x << ") = " << res;
+    check(res == pix);
+  }
+
+  // Random x near the boundaries of the algorithm
+  uint64_t seed = 1;
+
+  for (int i = 0; i < 100; i++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    x = (seed >> 11) % 300000000 + 1;
+    uint64_t res = primePiLMO(x, (i % 3) + 1);
+    std::cout << "primePiLMO(" << x << ") = " << res;
+    check(res == sieveCount(0, x));
+  }
+
+  // count_primes() uses LMO for large intervals
+  uint64_t start = 123456789;
+  uint64_t stop = 4000000000ull;
+  std::cout << "isPrimePiLMOUseful(" << start << ", " << stop << ")";
+  check(isPrimePiLMOUseful(start, stop));
+  uint64_t res = count_primes(start, stop);
+  std::cout << "count_primes(" << start << ", " << stop << ") = " << res;
+  check(res == sieveCount(start, stop));
+
+  std::cout << "isPrimePiLMOUseful(" << stop - 1000 << ", " << stop << ")";
+  check(!isPrimePiLMOUseful(stop - 1000, stop));
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
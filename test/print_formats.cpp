@@ -0,0 +1,241 @@
+///
+/// @file   print_formats.cpp
+/// @brief  Decode the output of the binary print formats
+///         (--format=u32|u64|varint|bitmap) and compare
+///         it with generate_primes().
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PrimeSieve.hpp>
+#include <primesieve/PrintBuffer.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace primesieve;
+
+// stdout is redirected to this file, hence
+// the results are printed to std::cerr.
+const char* outputFile = "print_formats.bin";
+
+void check(bool OK)
+{
+  std::cerr << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+  {
+    std::remove(outputFile);
+    std::exit(1);
+  }
+}
+
+std::string formatName(int format)
+{
+  switch (format)
+  {
+    case PRINT_UINT32: return "u32";
+    case PRINT_UINT64: return "u64";
+    case PRINT_VARINT: return "varint";
+    case PRINT_BITMAP: return "bitmap";
+    default: return "text";
+  }
+}
+
+/// Print the primes inside [start, stop] to stdout
+/// and return the output.
+///
+std::string printPrimes(uint64_t start, uint64_t stop, int format, int threads)
+{
+  if (!std::freopen(outputFile, "wb", stdout))
+  {
+    std::cerr << "Failed to redirect stdout to " << outputFile << "\n";
+    std::exit(1);
+  }
+
+  ParallelSieve ps;
+  ps.setFlags(PRINT_PRIMES | format);
+  ps.setStart(start);
+  ps.setStop(stop);
+  ps.setNumThreads(threads);
+  ps.sieve();
+  std::fflush(stdout);
+
+  std::ifstream file(outputFile, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+uint64_t decodeLittleEndian(const std::string& bytes, std::size_t i, int size)
+{
+  uint64_t n = 0;
+  for (int j = 0; j < size; j++)
+    n |= (uint64_t) (unsigned char) bytes[i + j] << (j * 8);
+  return n;
+}
+
+std::vector<uint64_t> decode(const std::string& bytes, uint64_t start, int format)
+{
+  std::vector<uint64_t> primes;
+
+  if (format == PRINT_UINT32 ||
+      format == PRINT_UINT64)
+  {
+    int size = (format == PRINT_UINT32) ? 4 : 8;
+    if (bytes.size() % size != 0)
+      return {};
+    for (std::size_t i = 0; i < bytes.size(); i += size)
+      primes.push_back(decodeLittleEndian(bytes, i, size));
+  }
+  else if (format == PRINT_VARINT)
+  {
+    const char* p = bytes.data();
+    const char* end = p + bytes.size();
+    uint64_t prime = 0;
+
+    while (p < end)
+    {
+      uint64_t delta;
+      p = PrintBuffer::decodeVarint(p, &delta);
+      prime += delta;
+      primes.push_back(prime);
+    }
+  }
+  else if (format == PRINT_BITMAP)
+  {
+    const uint64_t offsets[8] = { 7, 11, 13, 17, 19, 23, 29, 31 };
+    start = std::max<uint64_t>(start, 7);
+    uint64_t low = ((start - 7) / 30) * 30;
+
+    for (std::size_t i = 0; i < bytes.size(); i++)
+      for (int bit = 0; bit < 8; bit++)
+        if ((unsigned char) bytes[i] & (1u << bit))
+          primes.push_back(low + i * 30 + offsets[bit]);
+  }
+
+  return primes;
+}
+
+void test(uint64_t start, uint64_t stop, int format, int threads)
+{
+  std::string bytes = printPrimes(start, stop, format, threads);
+  std::vector<uint64_t> primes = decode(bytes, start, format);
+
+  // The bitmap format only contains primes >= 7
+  if (format == PRINT_BITMAP)
+    start = std::max<uint64_t>(start, 7);
+
+  std::vector<uint64_t> expected;
+  generate_primes(start, stop, &expected);
+
+  std::cerr << "--format=" << formatName(format) << " -t" << threads
+            << " [" << start << ", " << stop << "], primes = " << primes.size();
+  check(primes == expected);
+}
+
+void testVarint(uint64_t n)
+{
+  char buffer[10];
+  std::size_t size = PrintBuffer::encodeVarint(n, buffer);
+
+  uint64_t bits = 0;
+  for (uint64_t x = n; x > 0; x >>= 1)
+    bits++;
+  std::size_t expectedSize = (bits <= 7) ? 1 : (bits + 6) / 7;
+
+  uint64_t res;
+  const char* end = PrintBuffer::decodeVarint(buffer, &res);
+
+  std::cerr << "decodeVarint(encodeVarint(" << n << ")) = " << res;
+  check(res == n &&
+        size == expectedSize &&
+        end == buffer + size);
+}
+
+void testUint32Overflow(uint64_t start, uint64_t stop, int threads)
+{
+  bool isError = false;
+  std::string bytes;
+
+  try
+  {
+    bytes = printPrimes(start, stop, PRINT_UINT32, threads);
+  }
+  catch (const primesieve_error& e)
+  {
+    std::cerr << e.what() << "\n";
+    isError = true;
+  }
+
+  // No primes must be printed before the error
+  std::fflush(stdout);
+  std::ifstream file(outputFile, std::ios::binary);
+  bool isEmpty = file.peek() == std::ifstream::traits_type::eof();
+
+  std::cerr << "--format=u32 -t" << threads << " [" << start << ", " << stop << "] throws";
+  check(isError && isEmpty);
+}
+
+int main()
+{
+  uint64_t max32 = 0xffffffffull;
+
+  for (uint64_t n : { 0ull, 1ull, 2ull, 127ull, 128ull, 255ull, 16383ull, 16384ull,
+                      (1ull << 32) - 1, 1ull << 32, (1ull << 63) - 1, 1ull << 63,
+                      ~0ull })
+    testVarint(n);
+
+  uint64_t x = 1;
+  for (int i = 0; i < 1000; i++)
+  {
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+    testVarint(x >> (i % 64));
+  }
+
+  int formats[] = { PRINT_UINT32, PRINT_UINT64, PRINT_VARINT, PRINT_BITMAP };
+
+  for (int format : formats)
+  {
+    for (int threads : { 1, 4 })
+    {
+      test(0, 0, format, threads);
+      test(0, 100, format, threads);
+      test(3, 1000, format, threads);
+      test(7, 7, format, threads);
+      test(8, 10, format, threads);
+      test(100, 3 * 10000000, format, threads);
+      test(max32 - 3 * 10000000, max32, format, threads);
+
+      if (format != PRINT_UINT32)
+        test(1000000000000ull, 1000000000000ull + 3 * 10000000, format, threads);
+    }
+
+    // Small intervals are sieved using a single thread
+    if (format != PRINT_UINT32)
+    {
+      test(max32 - 1000, max32 + 1000, format, 1);
+      test(18446744073709551557ull - 1000, 18446744073709551557ull, format, 1);
+    }
+  }
+
+  testUint32Overflow(0, max32 + 1, 1);
+  testUint32Overflow(max32 - 3 * 10000000, max32 + 1, 4);
+  testUint32Overflow(max32 + 1, max32 + 1000, 4);
+
+  std::remove(outputFile);
+  std::cerr << "\n";
+  std::cerr << "All tests passed successfully!\n";
+
+  return 0;
+}
@@ -0,0 +1,109 @@
+///
+/// @file   print_parallel.cpp
+/// @brief  Check that printing primes and prime k-tuplets
+///         using multiple threads produces exactly the same
+///         output as printing using a single thread.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/PrimeSieve.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+using namespace primesieve;
+
+// stdout is redirected to this file, hence
+// the results are printed to std::cerr.
+const char* outputFile = "print_parallel.txt";
+
+void check(bool OK)
+{
+  std::cerr << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+  {
+    std::remove(outputFile);
+    std::exit(1);
+  }
+}
+
+/// Print the primes (i = 0) or prime k-tuplets (i > 0)
+/// inside [start, stop] to stdout and return the output.
+///
+std::string print(int i, uint64_t start, uint64_t stop, int threads, uint64_t& count)
+{
+  if (!std::freopen(outputFile, "wb", stdout))
+  {
+    std::cerr << "Failed to redirect stdout to " << outputFile << "\n";
+    std::exit(1);
+  }
+
+  ParallelSieve ps;
+  ps.setFlags((PRINT_PRIMES << i) | (COUNT_PRIMES << i));
+  ps.setStart(start);
+  ps.setStop(stop);
+  ps.setNumThreads(threads);
+  ps.sieve();
+  std::fflush(stdout);
+  count = ps.getCount(i);
+
+  std::ifstream file(outputFile, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+void test(uint64_t start, uint64_t stop)
+{
+  for (int i = 0; i < 6; i++)
+  {
+    uint64_t count1;
+    uint64_t count4;
+    std::string output1 = print(i, start, stop, 1, count1);
+    std::string output4 = print(i, start, stop, 4, count4);
+    uint64_t lines = std::count(output1.begin(), output1.end(), '\n');
+
+    std::cerr << "-p" << (i + 1) << " -t4 [" << start << ", " << stop << "], lines = " << lines;
+    check(output1 == output4 &&
+          count1 == count4 &&
+          count1 == lines);
+  }
+}
+
+int main()
+{
+  // Each thread prints chunks of at least 10^7
+  uint64_t chunk = 10000000;
+
+  test(0, 3 * chunk);
+  test(123456789, 123456789 + 4 * chunk + 12345);
+
+  // There are no prime sextuplets and only
+  // a few prime quintuplets in these chunks,
+  // hence many segments print nothing.
+  uint64_t start = 1000000000000ull;
+  for (uint64_t i = 0; i < 3; i++)
+  {
+    std::cerr << "count_sextuplets(" << start + i * chunk << ", " << start + (i + 1) * chunk - 1 << ") = 0";
+    check(count_sextuplets(start + i * chunk, start + (i + 1) * chunk - 1) == 0);
+  }
+
+  test(start, start + 3 * chunk - 1);
+
+  std::remove(outputFile);
+  std::cerr << "\n";
+  std::cerr << "All tests passed successfully!\n";
+
+  return 0;
+}
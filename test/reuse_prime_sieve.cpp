@@ -0,0 +1,55 @@
+///
+/// @file   reuse_prime_sieve.cpp
+/// @brief  Sieve many intervals using the same PrimeSieve
+///         object, its memory is reused by each sieve() call.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/PrimeSieve.hpp>
+
+#include <stdint.h>
+#include <cstdlib>
+#include <iostream>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  PrimeSieve ps;
+  ps.setFlags(COUNT_PRIMES | COUNT_TWINS);
+
+  // Alternate between intervals that use EratBig
+  // and intervals that use only EratSmall.
+  uint64_t starts[] = { (uint64_t) 1e15, 1000, (uint64_t) 1e13, 0, (uint64_t) 1e18 };
+  uint64_t dist = (uint64_t) 3e7;
+
+  for (int i = 0; i < 3; i++)
+  {
+    for (uint64_t start : starts)
+    {
+      uint64_t stop = start + dist;
+      ps.sieve(start, stop);
+      std::cout << "PrimePi(" << start << ", " << stop << ") = " << ps.getCount(0);
+      check(ps.getCount(0) == count_primes(start, stop));
+      std::cout << "Twins(" << start << ", " << stop << ") = " << ps.getCount(1);
+      check(ps.getCount(1) == count_twins(start, stop));
+    }
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+///
+/// @file   sieving_primes_table.cpp
+/// @brief  Test the SievingPrimesTable which stores the sieving
+///         primes shared by all threads of ParallelSieve.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/ParallelSieve.hpp>
+#include <primesieve/SievingPrimesTable.hpp>
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace primesieve;
+
+const uint64_t offsets[8] = { 7, 11, 13, 17, 19, 23, 29, 31 };
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  for (uint64_t stop : { 0, 6, 7, 100, 1000003, 40000000 })
+  {
+    for (int threads : { 1, 3, 8 })
+    {
+      SievingPrimesTable table;
+      table.init(stop, threads);
+
+      std::vector<uint64_t> primes;
+      if (stop >= 7)
+        generate_primes(7, stop, &primes);
+
+      std::vector<uint64_t> decoded;
+      for (std::size_t i = 0; i < table.size(); i++)
+        for (int bit = 0; bit < 8; bit++)
+          if (table.data()[i] & (1 << bit))
+            decoded.push_back(i * 30 + offsets[bit]);
+
+      std::cout << "SievingPrimesTable(" << stop << ", " << threads << ") primes = " << decoded.size();
+      check(decoded == primes);
+      std::cout << "Table size = " << table.size();
+      check(table.size() % 8 == 0);
+    }
+  }
+
+  // Count using many chunks per thread
+  ParallelSieve ps;
+  ps.setNumThreads(4);
+  ps.sieve((uint64_t) 1e11, (uint64_t) 1e11 + (uint64_t) 1e9);
+  std::cout << "PrimePi[10^11, 10^11+10^9] = " << ps.getCount(0);
+  check(ps.getCount(0) == 39475591);
+
+  if (ps.idealNumThreads() > 1)
+  {
+    std::cout << "Shared sieving primes table used";
+    check(ps.getSievingPrimesTable() != nullptr);
+  }
+
+  // The table (sqrt(stop) numbers) would be larger than
+  // the distance sieved by each thread, hence each
+  // thread generates its own sieving primes.
+  ps.sieve((uint64_t) 1e16, (uint64_t) 1e16 + (uint64_t) 1e8);
+  std::cout << "PrimePi[10^16, 10^16+10^8] = " << ps.getCount(0);
+  check(ps.getCount(0) == 2714904);
+  std::cout << "Shared sieving primes table not used";
+  check(ps.getSievingPrimesTable() == nullptr);
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}
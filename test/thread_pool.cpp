@@ -0,0 +1,120 @@
+///
+/// @file   thread_pool.cpp
+/// @brief  Test the ThreadPool used by ParallelSieve, including
+///         nested and concurrent run() calls and exceptions.
+///
+/// Copyright (C) 2024 Kim Walisch, <kim.walisch@gmail.com>
+///
+/// This file is distributed under the BSD License. See the COPYING
+/// file in the top level directory.
+///
+
+#include <primesieve.hpp>
+#include <primesieve/ThreadPool.hpp>
+
+#include <stdint.h>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace primesieve;
+
+void check(bool OK)
+{
+  std::cout << "   " << (OK ? "OK" : "ERROR") << "\n";
+  if (!OK)
+    std::exit(1);
+}
+
+int main()
+{
+  ThreadPool& threadPool = ThreadPool::get();
+
+  {
+    std::vector<int> results(100, 0);
+    threadPool.run(100, [&](int i) { results[i] = i * i; });
+    bool OK = true;
+    for (int i = 0; i < 100; i++)
+      OK &= (results[i] == i * i);
+    std::cout << "run(100 tasks)";
+    check(OK);
+  }
+
+  {
+    std::atomic<int> sum(0);
+    threadPool.run(8, [&](int i)
+    {
+      threadPool.run(8, [&](int j) { sum += i * 8 + j; });
+    });
+    std::cout << "Nested run() = " << sum;
+    check(sum == 63 * 64 / 2);
+  }
+
+  {
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> counts(4, 0);
+
+    for (int t = 0; t < 4; t++)
+    {
+      threads.emplace_back([&, t]()
+      {
+        for (int i = 0; i < 50; i++)
+        {
+          std::atomic<uint64_t> count(0);
+          threadPool.run(4, [&](int j)
+          {
+            uint64_t start = (uint64_t) 1e9 * (j + 1);
+            count += count_primes(start, start + (uint64_t) 1e5);
+          });
+          counts[t] += count;
+        }
+      });
+    }
+
+    for (auto& thread : threads)
+      thread.join();
+
+    uint64_t expected = 0;
+    for (int j = 0; j < 4; j++)
+    {
+      uint64_t start = (uint64_t) 1e9 * (j + 1);
+      expected += count_primes(start, start + (uint64_t) 1e5);
+    }
+
+    bool OK = true;
+    for (uint64_t count : counts)
+      OK &= (count == expected * 50);
+    std::cout << "Concurrent run() = " << counts[0];
+    check(OK);
+  }
+
+  {
+    bool isError = false;
+    std::atomic<int> finished(0);
+
+    try
+    {
+      threadPool.run(10, [&](int i)
+      {
+        if (i == 5)
+          throw std::runtime_error("task 5 failed");
+        finished++;
+      });
+    }
+    catch (std::exception&)
+    {
+      isError = true;
+    }
+
+    std::cout << "Exception rethrown, finished tasks = " << finished;
+    check(isError && finished == 9);
+  }
+
+  std::cout << std::endl;
+  std::cout << "All tests passed successfully!" << std::endl;
+
+  return 0;
+}